@@ -0,0 +1,269 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace bench {
+
+namespace {
+struct Registered {
+    std::string name;
+    BenchmarkFn fn;
+    std::vector<int64_t> args;
+};
+
+struct Result {
+    std::string name;
+    int64_t iterations;
+    double realNsPerIter;
+    double cpuNsPerIter;
+    double itemsPerSecond;
+    double bytesPerSecond;
+    std::string label;
+};
+
+struct Options {
+    std::string jsonPath;
+    std::string filter;
+    double minTime = 0.5;
+    bool list = false;
+};
+
+constexpr int64_t kMaxIterations = 1000000000;
+
+static std::vector<Registered>& registry() {
+    static std::vector<Registered> benchmarks;
+    return benchmarks;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (const char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::ostringstream hex;
+                    hex << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    out += hex.str();
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    return out;
+}
+
+static std::string currentDate() {
+    const std::time_t now = std::time(nullptr);
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    return buf;
+}
+
+static Result runOne(const std::string& name, BenchmarkFn fn, int64_t arg, double minTime) {
+    int64_t iterations = 1;
+    for (;;) {
+        State state(arg, iterations);
+        fn(state);
+        const double real = state.getRealSeconds();
+        if (real >= minTime || iterations >= kMaxIterations) {
+            Result r;
+            r.name = name;
+            r.iterations = iterations;
+            r.realNsPerIter = real * 1e9 / static_cast<double>(iterations);
+            r.cpuNsPerIter = state.getCpuSeconds() * 1e9 / static_cast<double>(iterations);
+            r.itemsPerSecond = real > 0.0 ? static_cast<double>(state.getItemsProcessed()) / real : 0.0;
+            r.bytesPerSecond = real > 0.0 ? static_cast<double>(state.getBytesProcessed()) / real : 0.0;
+            r.label = state.getLabel();
+            return r;
+        }
+        // Aim past the minimum from the last timing, growing at most 10x per step.
+        const double multiplier = real > 0.0 ? std::min(10.0, std::max(1.4 * minTime / real, 1.1)) : 10.0;
+        iterations = std::min(kMaxIterations,
+                              std::max(iterations + 1, static_cast<int64_t>(static_cast<double>(iterations) * multiplier)));
+    }
+}
+
+static void writeJson(const std::string& path, const char* executable, const std::vector<Result>& results) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Cannot open JSON output: " << path << "\n";
+        return;
+    }
+#ifdef NDEBUG
+    const char* buildType = "release";
+#else
+    const char* buildType = "debug";
+#endif
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << currentDate() << "\",\n";
+    out << "    \"executable\": \"" << jsonEscape(executable) << "\",\n";
+    out << "    \"num_cpus\": " << std::max(1u, std::thread::hardware_concurrency()) << ",\n";
+    out << "    \"library_build_type\": \"" << buildType << "\"\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    out << std::setprecision(12);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"real_time\": " << r.realNsPerIter << ",\n";
+        out << "      \"cpu_time\": " << r.cpuNsPerIter << ",\n";
+        out << "      \"time_unit\": \"ns\"";
+        if (r.itemsPerSecond > 0.0) out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+        if (r.bytesPerSecond > 0.0) out << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+        if (!r.label.empty()) out << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+        out << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+static void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [--filter TEXT] [--min-time SECONDS] [--json FILE] [--list]\n"
+              << "  --filter TEXT     Run only benchmarks whose name contains TEXT\n"
+              << "  --min-time S      Minimum measured time per benchmark (default 0.5)\n"
+              << "  --json FILE       Also write results as Google Benchmark JSON\n"
+              << "  --list            Print benchmark names and exit\n";
+}
+
+static bool parseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto nextValue = [&](const char*& out) -> bool {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+
+        const char* value = nullptr;
+        if (arg == "--filter") {
+            if (!nextValue(value)) return false;
+            opts.filter = value;
+        } else if (arg == "--min-time") {
+            if (!nextValue(value)) return false;
+            opts.minTime = std::atof(value);
+        } else if (arg == "--json") {
+            if (!nextValue(value)) return false;
+            opts.jsonPath = value;
+        } else if (arg == "--list") {
+            opts.list = true;
+        } else {
+            return false;
+        }
+    }
+    return opts.minTime > 0.0;
+}
+} // namespace
+
+State::State(int64_t arg, int64_t iterations)
+    : arg(arg),
+      maxIterations(iterations),
+      done(0),
+      started(false),
+      paused(false),
+      cpuStart(0),
+      realSeconds(0.0),
+      cpuSeconds(0.0),
+      items(0),
+      bytes(0) {}
+
+void State::startClock() {
+    realStart = std::chrono::steady_clock::now();
+    cpuStart = std::clock();
+}
+
+void State::stopClock() {
+    realSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+    cpuSeconds += static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+}
+
+bool State::keepRunningSlow() {
+    if (!started) {
+        started = true;
+        startClock();
+        if (done < maxIterations) {
+            ++done;
+            return true;
+        }
+    }
+    if (!paused) {
+        stopClock();
+        paused = true;
+    }
+    return false;
+}
+
+void State::pauseTiming() {
+    if (paused) return;
+    stopClock();
+    paused = true;
+}
+
+void State::resumeTiming() {
+    if (!paused) return;
+    paused = false;
+    startClock();
+}
+
+Registration::Registration(const char* name, BenchmarkFn fn, std::vector<int64_t> args) {
+    registry().push_back(Registered{name, fn, std::move(args)});
+}
+
+} // namespace bench
+
+int main(int argc, char** argv) {
+    bench::Options opts;
+    if (!bench::parseArgs(argc, argv, opts)) {
+        bench::printUsage(argv[0]);
+        return 1;
+    }
+
+    // Expand each registration into one named run per argument.
+    std::vector<std::pair<std::string, std::pair<bench::BenchmarkFn, int64_t>>> runs;
+    for (const auto& reg : bench::registry()) {
+        if (reg.args.empty()) {
+            runs.push_back({reg.name, {reg.fn, 0}});
+        } else {
+            for (const int64_t a : reg.args) runs.push_back({reg.name + "/" + std::to_string(a), {reg.fn, a}});
+        }
+    }
+
+    std::vector<bench::Result> results;
+    if (!opts.list) {
+        std::cout << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(16) << "Time (ns)"
+                  << std::setw(16) << "CPU (ns)" << std::setw(14) << "Iterations" << "\n";
+    }
+    for (const auto& run : runs) {
+        if (!opts.filter.empty() && run.first.find(opts.filter) == std::string::npos) continue;
+        if (opts.list) {
+            std::cout << run.first << "\n";
+            continue;
+        }
+        results.push_back(bench::runOne(run.first, run.second.first, run.second.second, opts.minTime));
+        const bench::Result& r = results.back();
+        std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(16) << r.realNsPerIter << std::setw(16) << r.cpuNsPerIter << std::setw(14)
+                  << r.iterations;
+        if (r.itemsPerSecond > 0.0) std::cout << "  items/s=" << std::setprecision(0) << r.itemsPerSecond;
+        if (!r.label.empty()) std::cout << "  " << r.label;
+        std::cout << std::endl;
+    }
+
+    if (!opts.jsonPath.empty()) bench::writeJson(opts.jsonPath, argv[0], results);
+    return 0;
+}
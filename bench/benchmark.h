@@ -0,0 +1,93 @@
+#ifndef AURORA_BENCHMARK_H
+#define AURORA_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Minimal Google Benchmark-style harness. Benchmarks register themselves with
+// AURORA_BENCHMARK (or AURORA_BENCHMARK_ARGS) and time a
+// `while (state.keepRunning())` loop; the runner grows the iteration count
+// until each run lasts at least the minimum time. Results print as a table
+// and can be written as Google Benchmark JSON.
+namespace bench {
+
+class State {
+private:
+    int64_t arg;
+    int64_t maxIterations;
+    int64_t done;
+    bool started;
+    bool paused;
+    std::chrono::steady_clock::time_point realStart;
+    std::clock_t cpuStart;
+    double realSeconds;
+    double cpuSeconds;
+    int64_t items;
+    int64_t bytes;
+    std::string label;
+
+    void startClock();
+    void stopClock();
+
+public:
+    State(int64_t arg, int64_t iterations);
+
+    // True while more timed iterations remain; starts the clock on the first
+    // call and stops it on the last.
+    bool keepRunning() {
+        if (started && done < maxIterations) {
+            ++done;
+            return true;
+        }
+        return keepRunningSlow();
+    }
+    bool keepRunningSlow();
+
+    // Excludes per-iteration setup from the measurement.
+    void pauseTiming();
+    void resumeTiming();
+
+    int64_t range() const { return arg; }
+    int64_t iterations() const { return maxIterations; }
+    void setItemsProcessed(int64_t n) { items = n; }
+    void setBytesProcessed(int64_t n) { bytes = n; }
+    void setLabel(const std::string& text) { label = text; }
+
+    double getRealSeconds() const { return realSeconds; }
+    double getCpuSeconds() const { return cpuSeconds; }
+    int64_t getItemsProcessed() const { return items; }
+    int64_t getBytesProcessed() const { return bytes; }
+    const std::string& getLabel() const { return label; }
+};
+
+using BenchmarkFn = void (*)(State&);
+
+struct Registration {
+    // Runs once per argument, or once with argument 0 when `args` is empty.
+    Registration(const char* name, BenchmarkFn fn, std::vector<int64_t> args = {});
+};
+
+// Keeps `value` observable so the optimizer cannot drop the work producing it.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+
+#define AURORA_BENCH_CONCAT2(a, b) a##b
+#define AURORA_BENCH_CONCAT(a, b) AURORA_BENCH_CONCAT2(a, b)
+#define AURORA_BENCHMARK(fn) \
+    static const bench::Registration AURORA_BENCH_CONCAT(benchRegistration_, __LINE__)(#fn, fn)
+#define AURORA_BENCHMARK_ARGS(fn, ...) \
+    static const bench::Registration AURORA_BENCH_CONCAT(benchRegistration_, __LINE__)(#fn, fn, {__VA_ARGS__})
+
+#endif // AURORA_BENCHMARK_H
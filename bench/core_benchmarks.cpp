@@ -0,0 +1,260 @@
+// Benchmarks for the game-logic hot paths in aurora_core.
+#include "benchmark.h"
+
+#include "combat.h"
+#include "diplomacy.h"
+#include "empire.h"
+#include "exploration.h"
+#include "galaxy.h"
+#include "game.h"
+#include "research.h"
+#include "rng.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace {
+static std::shared_ptr<Fleet> makeFleet(const std::string& name, int ships) {
+    auto fleet = std::make_shared<Fleet>(name);
+    for (int i = 0; i < ships; ++i) {
+        std::vector<Weapon> weapons{Weapon("Laser", 10, 0.8, 5), Weapon("Railgun", 20, 0.65, 6)};
+        fleet->addShip(std::make_shared<Ship>(name + " " + std::to_string(i), ShipClass::DESTROYER, 300, 140, weapons));
+    }
+    return fleet;
+}
+
+static void autopilotResearch(Game& game) {
+    if (!game.getEmpire()->getCurrentResearch().empty()) return;
+    auto available = game.getAvailableResearch();
+    if (!available.empty()) game.startResearch(available[0].getId());
+}
+
+// A game advanced `turns` turns with every system explored, so both hostiles
+// are at war and their fleets have had time to grow.
+static std::unique_ptr<Game> makeWarmGame(int turns) {
+    auto game = std::make_unique<Game>("Earth Empire", 42);
+    game->setNarrativeEnabled(false);
+    for (const StarSystem& sys : game->getGalaxy()->getSystems()) {
+        game->exploreSystem(sys.getName());
+    }
+    for (int t = 0; t < turns; ++t) {
+        autopilotResearch(*game);
+        game->advanceTurn();
+    }
+    return game;
+}
+
+static std::size_t hostileShipCount(const Game& game) {
+    std::size_t ships = 0;
+    for (const auto& h : game.getHostileEmpires()) {
+        for (const auto& f : h->getFleets()) ships += f->getShips().size();
+    }
+    return ships;
+}
+} // namespace
+
+static void BM_GalaxyGeneration(bench::State& state) {
+    const int systems = static_cast<int>(state.range());
+    uint32_t seed = 1;
+    while (state.keepRunning()) {
+        Galaxy galaxy(systems, seed++);
+        bench::doNotOptimize(galaxy.getSystems().size());
+    }
+    state.setItemsProcessed(state.iterations() * systems);
+}
+AURORA_BENCHMARK_ARGS(BM_GalaxyGeneration, 20, 200, 2000);
+
+static void BM_GalaxyGenerationParallel(bench::State& state) {
+    const int systems = static_cast<int>(state.range());
+    ThreadPool pool;
+    uint32_t seed = 1;
+    while (state.keepRunning()) {
+        Galaxy galaxy(systems, seed++, &pool);
+        bench::doNotOptimize(galaxy.getSystems().size());
+    }
+    state.setItemsProcessed(state.iterations() * systems);
+}
+AURORA_BENCHMARK_ARGS(BM_GalaxyGenerationParallel, 2000, 100000);
+
+// Regenerating a system's planets from the seed, then evicting them again.
+static void BM_SystemDetails(bench::State& state) {
+    Galaxy galaxy(static_cast<int>(state.range()), 1);
+    const auto systems = galaxy.getSystems();
+    std::size_t next = 1;
+    while (state.keepRunning()) {
+        bench::doNotOptimize(systems[next].getPlanets().size());
+        galaxy.evictUntouchedDetails();
+        if (++next == systems.size()) next = 1;
+    }
+}
+AURORA_BENCHMARK_ARGS(BM_SystemDetails, 2000);
+
+// Argument: number of technologies already researched.
+static void BM_AvailableTechs(bench::State& state) {
+    ResearchTree tree;
+    for (int64_t i = 0; i < state.range(); ++i) {
+        const auto available = tree.getAvailableTechs();
+        if (available.empty()) break;
+        tree.setTechStateForLoad(available[0].getId(), available[0].getCost(), true);
+    }
+    while (state.keepRunning()) {
+        bench::doNotOptimize(tree.getAvailableTechs());
+    }
+}
+AURORA_BENCHMARK_ARGS(BM_AvailableTechs, 0, 10, 25);
+
+// Empires share the tech catalogue, so construction only allocates progress.
+static void BM_EmpireConstruction(bench::State& state) {
+    while (state.keepRunning()) {
+        Empire empire("Bench Empire");
+        bench::doNotOptimize(empire.getResearch().getAvailableCount());
+    }
+}
+AURORA_BENCHMARK(BM_EmpireConstruction);
+
+// Cold plan for the deepest tech in the catalogue; the cache is dropped by
+// using a fresh tree each iteration.
+static void BM_ResearchPlan(bench::State& state) {
+    while (state.keepRunning()) {
+        ResearchTree tree;
+        bench::doNotOptimize(tree.planPathTo("temporal_weapons"));
+    }
+}
+AURORA_BENCHMARK(BM_ResearchPlan);
+
+// Argument: empire count. Every third pair is at war; one iteration lists the
+// enemies of every empire.
+static void BM_DiplomacyEnemies(bench::State& state) {
+    const auto n = static_cast<EmpireId>(state.range());
+    DiplomacyMatrix diplomacy(n);
+    for (EmpireId a = 0; a < n; ++a) {
+        for (EmpireId b = a + 1; b < n; ++b) {
+            if ((a + b) % 3 == 0) diplomacy.setStance(a, b, DiplomaticStance::WAR);
+        }
+    }
+    while (state.keepRunning()) {
+        uint64_t sum = 0;
+        for (EmpireId a = 0; a < n; ++a) {
+            diplomacy.forEachEnemy(a, [&sum](EmpireId e) { sum += e; });
+        }
+        bench::doNotOptimize(sum);
+    }
+    state.setItemsProcessed(state.iterations() * state.range());
+}
+AURORA_BENCHMARK_ARGS(BM_DiplomacyEnemies, 3, 200);
+
+// Argument: system count, every seventh one explored. One iteration is what
+// the explore menu asks for: both counts and the first ten unexplored systems.
+static void BM_ExplorationListing(bench::State& state) {
+    const auto n = static_cast<std::size_t>(state.range());
+    ExplorationMap exploration(1, n);
+    for (std::size_t s = 0; s < n; s += 7) exploration.explore(kPlayerEmpireId, static_cast<SystemId>(s));
+    while (state.keepRunning()) {
+        uint64_t sum = exploration.exploredCount(kPlayerEmpireId);
+        const auto unexplored = exploration.unexploredSystems(kPlayerEmpireId);
+        sum += unexplored.size();
+        int listed = 0;
+        for (const SystemId id : unexplored) {
+            if (listed++ == 10) break;
+            sum += id;
+        }
+        bench::doNotOptimize(sum);
+    }
+}
+AURORA_BENCHMARK_ARGS(BM_ExplorationListing, 20, 1000000);
+
+// Argument: ships per side. Fleet construction is excluded from the timing.
+static void BM_CombatResolve(bench::State& state) {
+    const int ships = static_cast<int>(state.range());
+    uint64_t battle = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        auto attacker = makeFleet("Attacker", ships);
+        auto defender = makeFleet("Defender", ships);
+        RandomStream rng(rngDeriveKey(7, battle++));
+        state.resumeTiming();
+
+        Combat combat(attacker, defender, rng, CombatRecording::NONE);
+        bench::doNotOptimize(combat.resolve());
+    }
+    state.setItemsProcessed(state.iterations() * ships * 2);
+}
+AURORA_BENCHMARK_ARGS(BM_CombatResolve, 1, 10, 100, 1000);
+
+// Same battles with the full replay (frames and log events) recorded.
+static void BM_CombatResolveRecorded(bench::State& state) {
+    const int ships = static_cast<int>(state.range());
+    uint64_t battle = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        auto attacker = makeFleet("Attacker", ships);
+        auto defender = makeFleet("Defender", ships);
+        RandomStream rng(rngDeriveKey(7, battle++));
+        state.resumeTiming();
+
+        Combat combat(attacker, defender, rng, CombatRecording::FULL);
+        bench::doNotOptimize(combat.resolve());
+    }
+    state.setItemsProcessed(state.iterations() * ships * 2);
+}
+AURORA_BENCHMARK_ARGS(BM_CombatResolveRecorded, 10, 100);
+
+// Argument: number of colonies the empire owns.
+static void BM_EmpireAdvanceTurn(bench::State& state) {
+    Galaxy galaxy(200, 3);
+    Empire empire("Bench Empire");
+    int colonies = 0;
+    for (StarSystem& sys : galaxy.getSystems()) {
+        for (Planet* planet : sys.getColonizablePlanets()) {
+            if (colonies >= state.range()) break;
+            auto colony = std::make_shared<Colony>(static_cast<ColonyId>(colonies), "Colony " + std::to_string(colonies), *planet);
+            ++colonies;
+            planet->colonize(colony->getId());
+            empire.addColony(colony);
+        }
+    }
+    while (state.keepRunning()) {
+        if (empire.getCurrentResearch().empty()) {
+            const auto available = empire.getResearch().getAvailableTechs();
+            if (!available.empty()) empire.setResearch(available[0].getId());
+        }
+        bench::doNotOptimize(empire.advanceTurn());
+    }
+}
+AURORA_BENCHMARK_ARGS(BM_EmpireAdvanceTurn, 1, 64);
+
+// Argument: turns played before timing starts; later games carry far larger
+// hostile fleets.
+static void BM_GameAdvanceTurn(bench::State& state) {
+    auto game = makeWarmGame(static_cast<int>(state.range()));
+    state.setLabel("hostile ships=" + std::to_string(hostileShipCount(*game)));
+    while (state.keepRunning()) {
+        autopilotResearch(*game);
+        bench::doNotOptimize(game->advanceTurn());
+    }
+}
+AURORA_BENCHMARK_ARGS(BM_GameAdvanceTurn, 0, 1000, 5000);
+
+// Argument: 0 = V1 text, 1 = V2 binary. One quickSave plus one quickLoad per
+// iteration on a game that has run 1000 turns.
+static void BM_QuickSaveLoad(bench::State& state) {
+    const SaveFormat format = state.range() == 0 ? SaveFormat::TEXT_V1 : SaveFormat::BINARY_V2;
+    const std::string path = state.range() == 0 ? "aurora_bench_save.txt" : "aurora_bench_save.sav";
+    auto game = makeWarmGame(1000);
+
+    game->quickSave(path, format);
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    const int64_t fileBytes = static_cast<int64_t>(probe.tellg());
+    probe.close();
+    state.setLabel(std::to_string(fileBytes) + " bytes");
+
+    while (state.keepRunning()) {
+        bench::doNotOptimize(game->quickSave(path, format));
+        bench::doNotOptimize(game->quickLoad(path));
+    }
+    state.setBytesProcessed(state.iterations() * fileBytes * 2);
+    std::remove(path.c_str());
+}
+AURORA_BENCHMARK_ARGS(BM_QuickSaveLoad, 0, 1);
@@ -0,0 +1,54 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "save_game.h"
+
+// Background save writer. The game thread hands over a finished SaveData
+// snapshot and returns immediately; a dedicated thread serializes it and
+// replaces the target file atomically.
+class AutosaveWriter {
+private:
+    struct Job {
+        std::unique_ptr<const SaveData> snapshot;
+        std::string path;
+        SaveFormat format;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    Job pending;
+    bool busy;
+    bool stopping;
+    int completed;
+    std::string lastResult;
+    std::thread worker;
+
+    void workerLoop();
+
+public:
+    AutosaveWriter();
+    // Finishes any queued save before returning.
+    ~AutosaveWriter();
+
+    AutosaveWriter(const AutosaveWriter&) = delete;
+    AutosaveWriter& operator=(const AutosaveWriter&) = delete;
+
+    // Queues a save. A queued snapshot that has not started writing yet is
+    // superseded, so a slow disk never builds a backlog.
+    void submit(SaveData snapshot, const std::string& path, SaveFormat format);
+
+    // Blocks until nothing is queued or being written.
+    void flush();
+
+    int getCompletedCount();
+    // Message from the most recent finished save ("Saved to ..." or an error).
+    std::string getLastResult();
+};
+
+#endif // AUTOSAVE_H
@@ -0,0 +1,31 @@
+#ifndef BATTLE_PREDICTOR_H
+#define BATTLE_PREDICTOR_H
+
+#include <array>
+#include <cstdint>
+#include "combat.h"
+
+class ThreadPool;
+
+// Aggregate result of many simulated trials of one engagement.
+struct BattlePrediction {
+    static constexpr int kHistogramBuckets = 10;
+
+    int samples = 0;
+    double attackerWinProbability = 0.0;
+    // Mean number of ships each side loses.
+    double expectedAttackerLosses = 0.0;
+    double expectedDefenderLosses = 0.0;
+    // Bucket i counts trials in which a side lost [i*10%, (i+1)*10%) of its
+    // starting hull + shields; the last bucket also holds total losses.
+    std::array<int, kHistogramBuckets> attackerDamageHistogram{};
+    std::array<int, kHistogramBuckets> defenderDamageHistogram{};
+};
+
+// Runs `samples` independent CombatKernel trials of attacker vs defender across
+// the pool. Trial i draws from a stream keyed by (seed, i), so the result does
+// not depend on the number of threads. The fleets are only read.
+BattlePrediction predictBattleOutcome(const Fleet& attacker, const Fleet& defender, int samples,
+                                      int maxRounds, uint64_t seed, ThreadPool& pool);
+
+#endif // BATTLE_PREDICTOR_H
@@ -0,0 +1,41 @@
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit; `w` must not be zero.
+inline int lowestBit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, w);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+// Index of the highest set bit; `w` must not be zero.
+inline int highestBit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, w);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(w);
+#endif
+}
+
+// Number of set bits.
+inline int popcount(uint64_t w) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(w));
+#else
+    return __builtin_popcountll(w);
+#endif
+}
+
+#endif // BIT_OPS_H
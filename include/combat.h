@@ -2,8 +2,12 @@
 #define COMBAT_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include "entity_id.h"
+#include "name_table.h"
+#include "rng.h"
 
 enum class ShipClass {
     SCOUT,
@@ -17,7 +21,7 @@ enum class ShipClass {
 };
 
 std::string shipClassToString(ShipClass sc);
-bool shipClassFromString(const std::string& s, ShipClass& out);
+bool shipClassFromString(std::string_view s, ShipClass& out);
 
 struct CombatShipState {
     std::string name;
@@ -46,13 +50,17 @@ private:
 public:
     Weapon(const std::string& name, int dmg, double acc, int rng);
     
-    int fire() const;
+    int fire(RandomStream& rng) const;
     const std::string& getName() const { return name; }
+    int getDamage() const { return damage; }
+    double getAccuracy() const { return accuracy; }
+    int getRange() const { return range; }
 };
 
 class Ship {
 private:
-    std::string name;
+    ShipId id;
+    NameId name;
     ShipClass shipClass;
     int maxHull;
     int hull;
@@ -62,63 +70,119 @@ private:
     bool destroyed;
 
 public:
-    Ship(const std::string& name, ShipClass sc, int hull, int shields,
-         const std::vector<Weapon>& wpns = {});
+    Ship(NameId name, ShipClass sc, int hull, int shields, const std::vector<Weapon>& wpns = {});
+    Ship(const std::string& name, ShipClass sc, int hull, int shields, const std::vector<Weapon>& wpns = {})
+        : Ship(internName(name), sc, hull, shields, wpns) {}
     
+    // Ships can be built off the game thread; the id is handed out afterwards.
+    void setId(ShipId shipId) { id = shipId; }
     void takeDamage(int damage);
-    int fireAt();
+    int fireAt(RandomStream& rng);
     bool isOperational() const { return !destroyed && hull > 0; }
     
-    const std::string& getName() const { return name; }
+    ShipId getId() const { return id; }
+    const std::string& getName() const { return nameOf(name); }
+    NameId getNameId() const { return name; }
     ShipClass getShipClass() const { return shipClass; }
     int getHull() const { return hull; }
     int getMaxHull() const { return maxHull; }
     int getShields() const { return shields; }
     int getMaxShields() const { return maxShields; }
+    const std::vector<Weapon>& getWeapons() const { return weapons; }
 };
 
-class StarSystem;
-
 class Fleet {
 private:
-    std::string name;
-    std::string owner;
+    FleetId id;
+    NameId name;
+    EmpireId owner;
     std::vector<std::shared_ptr<Ship>> ships;
-    std::shared_ptr<StarSystem> location;
+    SystemId location;
 
 public:
-    Fleet(const std::string& name, const std::string& owner);
+    Fleet(NameId name, EmpireId owner = kNoEntity, FleetId id = kNoEntity);
+    Fleet(const std::string& name, EmpireId owner = kNoEntity, FleetId id = kNoEntity)
+        : Fleet(internName(name), owner, id) {}
     
     void addShip(std::shared_ptr<Ship> ship);
     void removeDestroyed();
     int getCombatStrength() const;
     bool isDefeated() const;
     
-    const std::string& getName() const { return name; }
-    const std::string& getOwner() const { return owner; }
+    FleetId getId() const { return id; }
+    const std::string& getName() const { return nameOf(name); }
+    NameId getNameId() const { return name; }
+    EmpireId getOwner() const { return owner; }
     const std::vector<std::shared_ptr<Ship>>& getShips() const { return ships; }
     std::vector<std::shared_ptr<Ship>>& getShips() { return ships; }
-    void setLocation(std::shared_ptr<StarSystem> sys) { location = sys; }
-    std::shared_ptr<StarSystem> getLocation() const { return location; }
+    // kNoEntity when the fleet is nowhere; resolve through Galaxy::getSystem().
+    void setLocation(SystemId sys) { location = sys; }
+    SystemId getLocation() const { return location; }
+    bool hasLocation() const { return location != kNoEntity; }
+};
+
+// How much of a battle Combat keeps. FULL is what the battle viewer and the
+// combat simulation screen need; SUMMARY keeps only compact events for battles
+// nobody watches frame by frame; NONE keeps nothing but the outcome.
+enum class CombatRecording {
+    NONE,
+    SUMMARY,
+    FULL
+};
+
+struct CombatEvent {
+    enum class Kind {
+        ROUND_START,
+        HIT,
+        DESTROYED,
+        ROUND_SUMMARY,
+        STATUS,
+        VICTORY
+    };
+
+    Kind kind;
+    int round;
+    // Ships are kept alive by Combat's roster for as long as the Combat lives.
+    const Ship* actor;
+    const Ship* target;
+    // HIT: damage. ROUND_SUMMARY: attacker losses. VICTORY: 1 if by attrition.
+    int value;
+    // ROUND_SUMMARY: defender losses. VICTORY: 1 if the attacker won.
+    int value2;
 };
 
 class Combat {
 private:
     std::shared_ptr<Fleet> attacker;
     std::shared_ptr<Fleet> defender;
-    std::vector<std::string> combatLog;
+    CombatRecording recording;
+    std::vector<CombatEvent> events;
+    std::vector<std::shared_ptr<Ship>> roster;
+    mutable std::vector<std::string> combatLog;
+    mutable bool logRendered;
     int round;
     std::vector<CombatFrame> frames;
+    RandomStream& rng;
 
     void recordFrame();
+    void recordEvent(CombatEvent::Kind kind, const Ship* actor = nullptr, const Ship* target = nullptr,
+                     int value = 0, int value2 = 0);
+    void fireVolley(Fleet& shooters, Fleet& targets);
+    void renderLog() const;
 
 public:
-    Combat(std::shared_ptr<Fleet> atk, std::shared_ptr<Fleet> def);
+    // Draws from the caller's stream so battles replay exactly from a seed.
+    Combat(std::shared_ptr<Fleet> atk, std::shared_ptr<Fleet> def, RandomStream& rng,
+           CombatRecording recording = CombatRecording::FULL);
     
     void resolveRound();
     std::shared_ptr<Fleet> resolve(int maxRounds = 10);
-    const std::vector<std::string>& getLog() const { return combatLog; }
+
+    // Text is formatted from the recorded events on first call.
+    const std::vector<std::string>& getLog() const;
+    const std::vector<CombatEvent>& getEvents() const { return events; }
     const std::vector<CombatFrame>& getFrames() const { return frames; }
+    CombatRecording getRecording() const { return recording; }
 };
 
 #endif // COMBAT_H
@@ -0,0 +1,79 @@
+#ifndef COMBAT_KERNEL_H
+#define COMBAT_KERNEL_H
+
+#include <cstdint>
+#include <vector>
+#include "combat.h"
+#include "rng.h"
+
+enum class CombatSide : uint8_t {
+    ATTACKER = 0,
+    DEFENDER = 1
+};
+
+// Structure-of-arrays combat engine for large engagements.
+//
+// Packs both fleets into contiguous hull/shield/weapon arrays and keeps an
+// ordered alive-index list per side, so a round is one linear pass over the
+// shooters with no shared_ptr traffic. Given the same RandomStream state it
+// draws the same numbers in the same order as Combat and therefore produces
+// the same outcome, but it records no log or frames.
+class CombatKernel {
+public:
+    struct Outcome {
+        CombatSide winner = CombatSide::DEFENDER;
+        int rounds = 0;
+        bool byAttrition = false;
+    };
+
+    CombatKernel() = default;
+    CombatKernel(const Fleet& attacker, const Fleet& defender);
+
+    // Snapshots both fleets; the fleets themselves are never modified.
+    void load(const Fleet& attacker, const Fleet& defender);
+
+    // Restores every ship to its state at load() without reallocating, so one
+    // kernel can run many independent trials.
+    void reset();
+
+    void resolveRound(RandomStream& rng);
+    Outcome resolve(RandomStream& rng, int maxRounds = 10);
+
+    // Writes post-battle hull/shields back to the fleets that were loaded and
+    // removes destroyed ships, mirroring what Combat does in place. The fleets
+    // must not have changed since load().
+    void applyTo(Fleet& attacker, Fleet& defender) const;
+
+    std::size_t shipCount(CombatSide side) const { return sides[index(side)].hull.size(); }
+    std::size_t aliveCount(CombatSide side) const { return sides[index(side)].alive.size(); }
+    int getStrength(CombatSide side) const;
+    // Hull + shields of every loaded ship at load() time, and how much of it is gone.
+    int getStartTotal(CombatSide side) const;
+    int getDamageTaken(CombatSide side) const;
+    int getHull(CombatSide side, std::size_t ship) const { return sides[index(side)].hull[ship]; }
+    int getShields(CombatSide side, std::size_t ship) const { return sides[index(side)].shields[ship]; }
+
+private:
+    struct SideState {
+        std::vector<int> hull;
+        std::vector<int> shields;
+        std::vector<int> startHull;
+        std::vector<int> startShields;
+        // Ship i owns weapons [weaponBegin[i], weaponBegin[i + 1]).
+        std::vector<uint32_t> weaponBegin;
+        std::vector<int> weaponDamage;
+        std::vector<double> weaponAccuracy;
+        // Indices of operational ships in fleet order.
+        std::vector<uint32_t> alive;
+    };
+
+    SideState sides[2];
+
+    static std::size_t index(CombatSide side) { return static_cast<std::size_t>(side); }
+    static void loadSide(SideState& st, const Fleet& fleet);
+    static void resetSide(SideState& st);
+    static void fireVolley(const SideState& shooters, SideState& targets, RandomStream& rng);
+    static void applySide(const SideState& st, Fleet& fleet);
+};
+
+#endif // COMBAT_KERNEL_H
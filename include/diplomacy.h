@@ -0,0 +1,68 @@
+#ifndef DIPLOMACY_H
+#define DIPLOMACY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bit_ops.h"
+#include "entity_id.h"
+
+// At most one stance holds between two empires; NEUTRAL means none.
+enum class DiplomaticStance {
+    NEUTRAL,
+    WAR,
+    PEACE,
+    ALLIANCE
+};
+
+// Symmetric relations between every pair of empires, indexed by EmpireId.
+// Each relation (contact, war, peace, alliance) is its own N x N bit matrix,
+// so a query is one bit test and "all enemies of X" is a scan over X's row of
+// the war matrix, 64 empires per word. Contact is independent of the stance.
+class DiplomacyMatrix {
+private:
+    enum Plane { CONTACT, WAR, PEACE, ALLIANCE, PLANE_COUNT };
+
+    std::size_t empires = 0;
+    std::size_t wordsPerRow = 0;
+    std::vector<uint64_t> bits; // [plane][row][word]
+
+    uint64_t* row(Plane plane, EmpireId a) { return bits.data() + (plane * empires + a) * wordsPerRow; }
+    const uint64_t* row(Plane plane, EmpireId a) const { return bits.data() + (plane * empires + a) * wordsPerRow; }
+    bool test(Plane plane, EmpireId a, EmpireId b) const;
+    void assign(Plane plane, EmpireId a, EmpireId b, bool value);
+
+public:
+    DiplomacyMatrix() = default;
+    explicit DiplomacyMatrix(std::size_t empireCount) { reset(empireCount); }
+
+    // Drops every relation and resizes for ids [0, empireCount).
+    void reset(std::size_t empireCount);
+    std::size_t size() const { return empires; }
+
+    // Queries on unknown ids (or an empire with itself) answer "no relation".
+    bool hasContact(EmpireId a, EmpireId b) const { return test(CONTACT, a, b); }
+    bool atWar(EmpireId a, EmpireId b) const { return test(WAR, a, b); }
+    DiplomaticStance getStance(EmpireId a, EmpireId b) const;
+
+    void setContact(EmpireId a, EmpireId b, bool contact) { assign(CONTACT, a, b, contact); }
+    void setStance(EmpireId a, EmpireId b, DiplomaticStance stance);
+
+    std::size_t enemyCount(EmpireId a) const;
+    // Calls fn(EmpireId) for every empire at war with `a`, in id order.
+    template <typename Fn>
+    void forEachEnemy(EmpireId a, Fn&& fn) const;
+};
+
+template <typename Fn>
+void DiplomacyMatrix::forEachEnemy(EmpireId a, Fn&& fn) const {
+    if (a >= empires) return;
+    const uint64_t* words = row(WAR, a);
+    for (std::size_t w = 0; w < wordsPerRow; ++w) {
+        for (uint64_t bitsLeft = words[w]; bitsLeft != 0; bitsLeft &= bitsLeft - 1) {
+            fn(static_cast<EmpireId>(w * 64 + static_cast<std::size_t>(lowestBit(bitsLeft))));
+        }
+    }
+}
+
+#endif // DIPLOMACY_H
@@ -4,33 +4,45 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include "entity_id.h"
 #include "resources.h"
 #include "research.h"
+#include "name_index.h"
+#include "name_table.h"
 
 class Planet;
 
 class Colony {
 private:
-    std::string name;
-    std::shared_ptr<Planet> planet;
+    ColonyId id;
+    EmpireId owner;
+    NameId name;
+    PlanetId planet;
+    SystemId system;
     int population;
     int infrastructure;
     int mines;
     int factories;
 
 public:
-    Colony(const std::string& name, std::shared_ptr<Planet> planet);
+    Colony(ColonyId id, NameId name, const Planet& planet);
+    Colony(ColonyId id, const std::string& name, const Planet& planet) : Colony(id, internName(name), planet) {}
     
     void grow();
     void buildMine() { mines++; }
     void buildFactory() { factories++; }
 
+    void setOwner(EmpireId empire) { owner = empire; }
     void setPopulationForLoad(int p) { population = p; }
     void setMinesForLoad(int v) { mines = v; }
     void setFactoriesForLoad(int v) { factories = v; }
     
-    const std::string& getName() const { return name; }
-    std::shared_ptr<Planet> getPlanet() const { return planet; }
+    ColonyId getId() const { return id; }
+    EmpireId getOwner() const { return owner; }
+    const std::string& getName() const { return nameOf(name); }
+    NameId getNameId() const { return name; }
+    PlanetId getPlanetId() const { return planet; }
+    SystemId getSystemId() const { return system; }
     int getPopulation() const { return population; }
     int getMines() const { return mines; }
     int getFactories() const { return factories; }
@@ -40,26 +52,30 @@ class Fleet;
 
 class Empire {
 private:
+    EmpireId id;
     std::string name;
     ResourceStorage resources;
     ResearchTree research;
     std::vector<std::shared_ptr<Colony>> colonies;
     std::vector<std::shared_ptr<Fleet>> fleets;
+    NameIndex<Fleet> fleetsByName;
     int turn;
     std::string currentResearch;
     int totalPopulation;
     int militaryStrength;
 
 public:
-    Empire(const std::string& name = "Earth Empire");
+    Empire(const std::string& name = "Earth Empire", EmpireId id = kPlayerEmpireId);
     
     std::string advanceTurn();
     bool setResearch(const std::string& techId);
     void setTurnForLoad(int t) { turn = t; }
     void setCurrentResearchForLoad(const std::string& techId) { currentResearch = techId; }
+    // Also makes this empire the colony's owner.
     void addColony(std::shared_ptr<Colony> colony);
     void addFleet(std::shared_ptr<Fleet> fleet);
     
+    EmpireId getId() const { return id; }
     const std::string& getName() const { return name; }
     int getTurn() const { return turn; }
     ResourceStorage& getResources() { return resources; }
@@ -68,6 +84,8 @@ public:
     const ResearchTree& getResearch() const { return research; }
     const std::vector<std::shared_ptr<Colony>>& getColonies() const { return colonies; }
     const std::vector<std::shared_ptr<Fleet>>& getFleets() const { return fleets; }
+    // Case-insensitive; one hash probe, no allocation.
+    std::shared_ptr<Fleet> findFleetByName(const std::string& fleetName) const;
     const std::string& getCurrentResearch() const { return currentResearch; }
 };
 
@@ -0,0 +1,33 @@
+#ifndef ENTITY_ID_H
+#define ENTITY_ID_H
+
+#include <cstdint>
+
+// Stable 32-bit ids for game entities. Relations between entities (ownership,
+// location, diplomacy) are stored as ids, so following or comparing one never
+// hashes or compares a name.
+using EmpireId = uint32_t;
+using SystemId = uint32_t;
+using PlanetId = uint32_t;
+using ColonyId = uint32_t;
+using FleetId = uint32_t;
+using ShipId = uint32_t;
+
+constexpr uint32_t kNoEntity = 0xFFFFFFFFu;
+
+// The player is always empire 0; AI empires follow in hostile-list order.
+constexpr EmpireId kPlayerEmpireId = 0;
+
+// Hands out ids of one kind in creation order. Systems and planets are
+// numbered by the galaxy generator instead, so they match across reloads.
+class IdAllocator {
+private:
+    uint32_t next = 0;
+
+public:
+    uint32_t allocate() { return next++; }
+    uint32_t count() const { return next; }
+    void reset() { next = 0; }
+};
+
+#endif // ENTITY_ID_H
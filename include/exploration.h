@@ -0,0 +1,126 @@
+#ifndef EXPLORATION_H
+#define EXPLORATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "bit_ops.h"
+#include "entity_id.h"
+
+// Ascending SystemIds whose bit in one empire's row is set (or, for an
+// "unexplored" view, clear). Reads the row in place, 64 systems per word, so
+// it is only valid until that row next changes.
+class SystemIdView {
+private:
+    const uint64_t* words = nullptr;
+    std::size_t wordCount = 0;
+    // All ones for an unexplored view; the row's padding bits are always
+    // zero, so lastMask drops them after flipping.
+    uint64_t flip = 0;
+    uint64_t lastMask = 0;
+    std::size_t count = 0;
+
+    uint64_t word(std::size_t w) const {
+        const uint64_t bits = words[w] ^ flip;
+        return w + 1 == wordCount ? bits & lastMask : bits;
+    }
+
+public:
+    class iterator;
+
+    SystemIdView() = default;
+    SystemIdView(const uint64_t* words, std::size_t wordCount, bool flipped, uint64_t lastMask, std::size_t count)
+        : words(words), wordCount(wordCount), flip(flipped ? ~uint64_t{0} : 0), lastMask(lastMask), count(count) {}
+
+    iterator begin() const;
+    iterator end() const;
+    // O(1): the map keeps the counts.
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+// Holds its own copy of the view, so it outlives the view it came from.
+class SystemIdView::iterator {
+private:
+    SystemIdView view;
+    std::size_t w = 0;
+    uint64_t bitsLeft = 0;
+
+    void skipEmpty() {
+        while (bitsLeft == 0 && ++w < view.wordCount) bitsLeft = view.word(w);
+    }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = SystemId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const SystemId*;
+    using reference = SystemId;
+
+    iterator() = default;
+    iterator(const SystemIdView& view, std::size_t w) : view(view), w(w) {
+        if (w < view.wordCount) {
+            bitsLeft = view.word(w);
+            skipEmpty();
+        }
+    }
+
+    SystemId operator*() const {
+        return static_cast<SystemId>(w * 64 + static_cast<std::size_t>(lowestBit(bitsLeft)));
+    }
+    iterator& operator++() {
+        bitsLeft &= bitsLeft - 1;
+        skipEmpty();
+        return *this;
+    }
+    iterator operator++(int) {
+        iterator old = *this;
+        ++*this;
+        return old;
+    }
+    bool operator==(const iterator& other) const { return w == other.w && bitsLeft == other.bitsLeft; }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+};
+
+inline SystemIdView::iterator SystemIdView::begin() const { return iterator(*this, 0); }
+inline SystemIdView::iterator SystemIdView::end() const { return iterator(*this, wordCount); }
+
+// Which systems each empire has explored, indexed by EmpireId. Each empire's
+// row is a bitset over SystemIds with its explored count kept alongside, so
+// counting is O(1) and listing scans the row 64 systems per word. Saves keep
+// only the player's row; AIs do not explore yet.
+class ExplorationMap {
+private:
+    std::size_t empires = 0;
+    std::size_t systems = 0;
+    std::size_t wordsPerRow = 0;
+    std::vector<uint64_t> bits; // [empire][word]
+    std::vector<std::size_t> explored;
+
+    const uint64_t* row(EmpireId e) const { return bits.data() + e * wordsPerRow; }
+    uint64_t lastWordMask() const;
+
+public:
+    ExplorationMap() = default;
+    ExplorationMap(std::size_t empireCount, std::size_t systemCount) { reset(empireCount, systemCount); }
+
+    // Forgets everything and resizes for empires [0, empireCount) and systems
+    // [0, systemCount).
+    void reset(std::size_t empireCount, std::size_t systemCount);
+    std::size_t empireCount() const { return empires; }
+    std::size_t systemCount() const { return systems; }
+
+    // Unknown ids count as unexplored and cannot be explored.
+    bool isExplored(EmpireId e, SystemId s) const;
+    // Returns true if `e` had not explored `s` before.
+    bool explore(EmpireId e, SystemId s);
+
+    std::size_t exploredCount(EmpireId e) const { return e < empires ? explored[e] : 0; }
+    std::size_t unexploredCount(EmpireId e) const { return e < empires ? systems - explored[e] : 0; }
+    // Empty for an unknown empire.
+    SystemIdView exploredSystems(EmpireId e) const;
+    SystemIdView unexploredSystems(EmpireId e) const;
+};
+
+#endif // EXPLORATION_H
@@ -3,94 +3,198 @@
 
 #include <string>
 #include <vector>
-#include <map>
-#include <memory>
-#include <random>
 #include <cstdint>
+#include "entity_id.h"
 #include "resources.h"
+#include "spatial_index.h"
+#include "name_index.h"
+#include "name_table.h"
+#include "span.h"
 
+class ThreadPool;
+
+// How a galaxy is built from its seed. Saves record it, so a game reloads into
+// the galaxy it was played in even after the default changes.
+enum class GalaxyGenerator : uint32_t {
+    // The original generator: one std::mt19937 drawn through every system in
+    // turn, so it can only run serially.
+    SEQUENTIAL_MT19937 = 1,
+    // Each system draws from a counter-based stream keyed by (seed, system)
+    // and each planet from one keyed by (seed, system, planet), so systems
+    // generate independently and in parallel with identical results.
+    COUNTER_STREAMS = 2
+};
+
+// Star and planet names are not stored: they are the system's name plus
+// " Primary" or an orbit letter, built when asked for.
 class Star {
 private:
-    std::string name;
-    std::string starType;
+    NameId systemName;
+    uint8_t starType;
 
 public:
-    Star(const std::string& name, std::mt19937& gen, const std::string& type = "");
+    Star(NameId systemName, uint8_t starType) : systemName(systemName), starType(starType) {}
     
-    const std::string& getName() const { return name; }
-    const std::string& getStarType() const { return starType; }
+    std::string getName() const;
+    const std::string& getStarType() const;
 };
 
-class Colony;
-
 class Planet {
 private:
-    std::string name;
-    std::string planetType;
-    std::map<ResourceType, int> minerals;
-    bool colonized;
-    std::shared_ptr<Colony> colony;
-    
-    void generateMinerals(std::mt19937& gen);
+    // First, so the cache-line-aligned amounts leave no padding behind them.
+    ResourceAmounts minerals;
+    PlanetId id;
+    SystemId system;
+    NameId systemName;
+    // The owning empire holds the colony; the planet only names it.
+    ColonyId colony;
+    uint8_t orbit;
+    uint8_t planetType;
 
 public:
-    Planet(const std::string& name, std::mt19937& gen, const std::string& type = "");
+    // `orbit` counts from 0 and gives the name's letter.
+    Planet(PlanetId id, SystemId system, NameId systemName, int orbit, int planetType,
+           const ResourceAmounts& minerals);
     
-    void colonize(std::shared_ptr<Colony> col);
+    void colonize(ColonyId col) { colony = col; }
     
-    const std::string& getName() const { return name; }
-    const std::string& getPlanetType() const { return planetType; }
-    const std::map<ResourceType, int>& getMinerals() const { return minerals; }
-    bool isColonized() const { return colonized; }
+    PlanetId getId() const { return id; }
+    SystemId getSystemId() const { return system; }
+    // "<system> A", "<system> B", ... in orbit order.
+    std::string getName() const;
+    char getOrbitLetter() const { return static_cast<char>('A' + orbit); }
+    const std::string& getPlanetType() const;
+    // Terrestrial and ocean worlds can be colonized.
+    bool isHabitable() const;
+    const ResourceAmounts& getMinerals() const { return minerals; }
+    bool isColonized() const { return colony != kNoEntity; }
+    // kNoEntity until colonized.
+    ColonyId getColonyId() const { return colony; }
 };
 
+class Galaxy;
+
+// A system's compact record, stored by value in the galaxy. Its planets are
+// regenerated from the galaxy seed into the galaxy's planet arena the first
+// time anything asks for them (exploring, colonizing or inspecting the
+// system), and Galaxy::evictUntouchedDetails() drops them again while no
+// planet is colonized.
 class StarSystem {
 private:
-    std::string name;
+    friend class Galaxy;
+
+    static constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+
+    SystemId id;
+    NameId name;
     int x, y, z;
-    Star star;
-    std::vector<std::shared_ptr<Planet>> planets;
-    bool explored;
-    
-    void generatePlanets(std::mt19937& gen);
+    Galaxy* galaxy;
+    PlanetId firstPlanet;
+    // Arena index of the first planet, or kNoSlot while they are not in
+    // memory. Set from const getters, so like the rest of the galaxy it must
+    // only be touched from one thread at a time.
+    mutable uint32_t planetSlot;
+    uint8_t planetCount;
+    uint8_t starType;
 
 public:
-    StarSystem(const std::string& name, std::mt19937& gen, int x = 0, int y = 0, int z = 0);
+    // Planets are numbered firstPlanet, firstPlanet + 1, ... in orbit order.
+    // The galaxy generator builds systems; see galaxy.cpp.
+    StarSystem(SystemId id, NameId name, uint8_t starType, Galaxy* galaxy,
+               PlanetId firstPlanet, int planetCount, int x = 0, int y = 0, int z = 0);
     
-    void explore() { explored = true; }
-    std::vector<std::shared_ptr<Planet>> getColonizablePlanets() const;
+    std::vector<Planet*> getColonizablePlanets();
+    // Same answer as !getColonizablePlanets().empty(), without creating the
+    // planets when they are not resident.
+    bool hasColonizablePlanet() const;
     
-    const std::string& getName() const { return name; }
+    SystemId getId() const { return id; }
+    const std::string& getName() const { return nameOf(name); }
+    NameId getNameId() const { return name; }
     int getX() const { return x; }
     int getY() const { return y; }
     int getZ() const { return z; }
-    const Star& getStar() const { return star; }
-    const std::vector<std::shared_ptr<Planet>>& getPlanets() const { return planets; }
-    bool isExplored() const { return explored; }
+    Star getStar() const { return Star(name, starType); }
+    std::size_t getPlanetCount() const { return planetCount; }
+    // In orbit order. Loading or evicting other systems' planets may move
+    // these, so hold PlanetIds rather than the span across such calls.
+    Span<Planet> getPlanets();
+    Span<const Planet> getPlanets() const;
+    // Whether the planets are currently in memory.
+    bool hasPlanetDetails() const { return planetSlot != kNoSlot; }
 };
 
 class Galaxy {
 private:
-    std::vector<std::shared_ptr<StarSystem>> systems;
-    std::shared_ptr<StarSystem> homeSystem;
+    friend class StarSystem;
+
+    // Indexed by SystemId; sized once by the generator and never moved, so
+    // pointers to systems stay valid for the galaxy's lifetime.
+    std::vector<StarSystem> systems;
+    // Planets in memory. Each system's planets are one contiguous block
+    // starting at its planetSlot.
+    mutable std::vector<Planet> planets;
+    SpatialIndex spatialIndex;
+    NameIndex<StarSystem, StarSystem*> systemsByName;
+    // Planets of system s have ids [planetOffsets[s], planetOffsets[s + 1]).
+    std::vector<PlanetId> planetOffsets;
+    // Systems whose planets were regenerated and may be evicted again, in
+    // arena order.
+    mutable std::vector<SystemId> detailed;
 
     uint32_t seed;
-    std::mt19937 gen;
-    
-    void generateGalaxy(int numSystems);
-    std::string generateStarName(int index);
+    GalaxyGenerator generator;
+
+    void generateSequential(int numSystems);
+    void generateFromStreams(int numSystems, ThreadPool* workers);
+    void finishGeneration();
+    void buildSpatialIndex();
+    void loadPlanets(const StarSystem& sys) const;
+    Planet* planetsOf(const StarSystem& sys) const;
+    bool hasColonizableType(const StarSystem& sys) const;
+    static std::vector<SystemId> idsOf(const std::vector<std::size_t>& indices);
 
 public:
-    Galaxy(int numSystems = 20, uint32_t seed = 0);
-    
-    std::vector<std::shared_ptr<StarSystem>> getExploredSystems() const;
-    std::vector<std::shared_ptr<StarSystem>> getUnexploredSystems() const;
+    // A null `workers` generates on the calling thread; the galaxy is the same
+    // either way. SEQUENTIAL_MT19937 always runs serially.
+    Galaxy(int numSystems = 20, uint32_t seed = 0, ThreadPool* workers = nullptr,
+           GalaxyGenerator generator = GalaxyGenerator::COUNTER_STREAMS);
+    // Systems point back at their galaxy.
+    Galaxy(const Galaxy&) = delete;
+    Galaxy& operator=(const Galaxy&) = delete;
 
     uint32_t getSeed() const { return seed; }
-    std::shared_ptr<StarSystem> findSystemByName(const std::string& name) const;
+    GalaxyGenerator getGenerator() const { return generator; }
+    // Ids are dense: systems are numbered by position in getSystems(), planets
+    // system by system. Both return null for an unknown id; getPlanet() loads
+    // the planet's system if needed.
+    StarSystem* getSystem(SystemId id) { return id < systems.size() ? &systems[id] : nullptr; }
+    const StarSystem* getSystem(SystemId id) const { return id < systems.size() ? &systems[id] : nullptr; }
+    Planet* getPlanet(PlanetId id);
+    const Planet* getPlanet(PlanetId id) const;
+    std::size_t getPlanetCount() const { return planetOffsets.empty() ? 0 : planetOffsets.back(); }
+
+    // Drops the regenerated planets of every system that has no colony and
+    // compacts the arena; they come back unchanged on next use.
+    // SEQUENTIAL_MT19937 galaxies cannot regenerate one system, so they keep
+    // every planet. Returns the number of systems evicted.
+    std::size_t evictUntouchedDetails();
+    // Systems whose planets are in memory.
+    std::size_t getDetailedSystemCount() const;
+    // Case-insensitive; one hash probe, no allocation.
+    StarSystem* findSystemByName(const std::string& name) { return systemsByName.find(name); }
+    const StarSystem* findSystemByName(const std::string& name) const { return systemsByName.find(name); }
+
+    // Spatial queries over system coordinates, answered by a k-d tree.
+    std::vector<SystemId> findSystemsWithin(int x, int y, int z, double radius) const;
+    std::vector<SystemId> findNearestSystems(int x, int y, int z, std::size_t k) const;
+    std::vector<SystemId> findSystemsInBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ) const;
     
-    const std::vector<std::shared_ptr<StarSystem>>& getSystems() const { return systems; }
-    std::shared_ptr<StarSystem> getHomeSystem() const { return homeSystem; }
+    Span<StarSystem> getSystems() { return Span<StarSystem>(systems.data(), systems.size()); }
+    Span<const StarSystem> getSystems() const { return Span<const StarSystem>(systems.data(), systems.size()); }
+    // Sol, system 0.
+    StarSystem& getHomeSystem() { return systems.front(); }
+    const StarSystem& getHomeSystem() const { return systems.front(); }
 };
 
 #endif // GALAXY_H
@@ -4,41 +4,124 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <map>
 #include <cstdint>
 #include "empire.h"
 #include "galaxy.h"
 #include "combat.h"
+#include "rng.h"
+#include "save_game.h"
+#include "autosave.h"
+#include "battle_predictor.h"
+#include "diplomacy.h"
+#include "exploration.h"
+#include "thread_pool.h"
+
+enum class HomeworldPlacement {
+    // Farthest-point sampling from Sol: each AI gets the system farthest from
+    // every homeworld placed so far, preferring systems with a colonizable planet.
+    SPREAD,
+    // Uniformly random distinct systems, drawn from the galaxy seed.
+    RANDOM
+};
+
+// New-game parameters. The defaults give the classic 20-system, two-AI game.
+struct GameSetup {
+    int galaxySystems = 20;
+    int aiCount = 2;
+    HomeworldPlacement placement = HomeworldPlacement::SPREAD;
+};
 
 class Game {
 private:
     std::shared_ptr<Empire> empire;
     std::shared_ptr<Galaxy> galaxy;
+    RngService rng;
+    std::unique_ptr<ThreadPool> workers;
+    int autosaveInterval;
+    std::string autosavePath;
+    SaveFormat autosaveFormat;
+    std::unique_ptr<AutosaveWriter> autosaver;
     std::vector<std::shared_ptr<Empire>> hostileEmpires;
-    std::map<std::string, bool> hostileContacted;
-    std::map<std::string, bool> hostileAtWar;
+    NameIndex<Empire> hostilesByName;
+    // Player and AIs alike; saves keep only the player's row.
+    DiplomacyMatrix diplomacy;
+    // Rows for the player and every AI; saves keep only the player's.
+    ExplorationMap exploration;
+    IdAllocator colonyIds;
+    IdAllocator fleetIds;
+    IdAllocator shipIds;
     bool running;
+    bool narrative;
+    bool parallelAi;
     
-    void setupGame();
+    // Below this many systems the galaxy generates faster than the pool starts.
+    static constexpr int kParallelGalaxySystems = 4096;
+
+    void setupGame(const GameSetup& setup);
+    ThreadPool* galaxyWorkers(int systems);
+    std::vector<SystemId> placeHomeworlds(int count, HomeworldPlacement placement) const;
     std::shared_ptr<Fleet> createStartingFleet();
+    void restoreSaveData(const SaveData& data);
+    void indexHostiles();
+    // Gives the ship its id, then adds it.
+    void addShipTo(Fleet& fleet, std::shared_ptr<Ship> ship);
 
 public:
-    Game(const std::string& empireName = "Earth Empire", uint32_t galaxySeed = 0);
+    Game(const std::string& empireName = "Earth Empire", uint32_t galaxySeed = 0,
+         const GameSetup& setup = GameSetup());
     
+    // Returns the turn narrative; empty when narrative output is disabled.
     std::string advanceTurn();
     std::string exploreSystem(const std::string& systemName);
     std::string startResearch(const std::string& techId);
-    std::vector<std::shared_ptr<Technology>> getAvailableResearch();
+    std::vector<Technology> getAvailableResearch();
     std::string buildShip(ShipClass shipClass, const std::string& fleetName);
     std::string simulateCombat(const std::string& fleet1Name, const std::string& fleet2Name);
 
-    std::string quickSave(const std::string& path = "savegame.txt") const;
+    // Monte Carlo forecast of attacker vs defender over `samples` trials on all
+    // cores. Works on snapshots; neither fleet is modified.
+    BattlePrediction predictBattle(const std::shared_ptr<Fleet>& attacker, const std::shared_ptr<Fleet>& defender,
+                                   int samples = 10000, int maxRounds = 10);
+
+    std::string quickSave(const std::string& path = "savegame.txt", SaveFormat format = SaveFormat::TEXT_V1) const;
+    // Accepts either save format.
     std::string quickLoad(const std::string& path = "savegame.txt");
+    SaveData captureSaveData() const;
+
+    // Every `everyTurns` turns (0 disables) advanceTurn() snapshots the game and
+    // a background thread writes it to `path`, so saving never stalls a turn.
+    void setAutosave(int everyTurns, const std::string& path = "autosave.sav",
+                     SaveFormat format = SaveFormat::BINARY_V2);
+    // Waits for any in-flight autosave and returns its result message.
+    std::string flushAutosave();
     
     std::shared_ptr<Empire> getEmpire() { return empire; }
     std::shared_ptr<Galaxy> getGalaxy() { return galaxy; }
     const std::vector<std::shared_ptr<Empire>>& getHostileEmpires() const { return hostileEmpires; }
+    // The player for kPlayerEmpireId, otherwise the AI; null if unknown.
+    std::shared_ptr<Empire> getEmpireById(EmpireId id) const;
+    RngService& getRng() { return rng; }
+    // Worker pool shared by parallel game systems, created on first use.
+    ThreadPool& getWorkers();
+
+    // Headless runs disable the per-turn narrative to skip all log formatting.
+    void setNarrativeEnabled(bool enabled) { narrative = enabled; }
+    bool isNarrativeEnabled() const { return narrative; }
+
+    // AI decide/produce phases run on the worker pool when there are enough
+    // AIs. Results are identical either way; turning it off is for checking that.
+    void setParallelAiEnabled(bool enabled) { parallelAi = enabled; }
+    bool isParallelAiEnabled() const { return parallelAi; }
+
+    // Which systems each empire has explored; the UI shows kPlayerEmpireId's row.
+    const ExplorationMap& getExploration() const { return exploration; }
 
+    DiplomacyMatrix& getDiplomacy() { return diplomacy; }
+    const DiplomacyMatrix& getDiplomacy() const { return diplomacy; }
+    // Relations of the player with one AI.
+    bool isHostileContacted(EmpireId hostile) const { return diplomacy.hasContact(kPlayerEmpireId, hostile); }
+    bool isHostileAtWar(EmpireId hostile) const { return diplomacy.atWar(kPlayerEmpireId, hostile); }
+    // Case-insensitive name lookups for the UI.
     bool isHostileContacted(const std::string& hostileName) const;
     bool isHostileAtWar(const std::string& hostileName) const;
 };
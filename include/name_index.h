@@ -0,0 +1,108 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Case-insensitive FNV-1a hash; folds each byte on the fly instead of building
+// a lowercased copy.
+inline uint64_t foldedNameHash(std::string_view s) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (const char c : s) {
+        h ^= static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+inline bool foldedNamesEqual(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive name -> entity index. Lookups are one hash probe plus one
+// folded compare, with no allocation. When several entities share a name the
+// first one inserted wins, matching a front-to-back linear scan. Entries live
+// in one open-addressed array, so a large index is a single allocation.
+// `Handle` is how entities are held: shared_ptr by default, or a plain
+// pointer into storage that never moves.
+template <typename T, typename Handle = std::shared_ptr<T>>
+class NameIndex {
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        Handle entity{}; // null marks an empty slot
+    };
+
+    std::vector<Slot> slots;
+    std::size_t used = 0;
+    // Entities whose hash is held by a different name (a true 64-bit
+    // collision); searched linearly, so effectively always empty.
+    std::vector<Handle> collisions;
+
+    // The slot holding `hash`, or the empty slot where it would go.
+    std::size_t probe(uint64_t hash) const {
+        const std::size_t mask = slots.size() - 1;
+        std::size_t i = static_cast<std::size_t>(hash) & mask;
+        while (slots[i].entity && slots[i].hash != hash) i = (i + 1) & mask;
+        return i;
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        for (Slot& slot : old) {
+            if (slot.entity) slots[probe(slot.hash)] = std::move(slot);
+        }
+    }
+
+public:
+    void clear() {
+        slots.clear();
+        used = 0;
+        collisions.clear();
+    }
+
+    // Sizes the table for n entries at most half full.
+    void reserve(std::size_t n) {
+        std::size_t capacity = 16;
+        while (capacity < 2 * n) capacity *= 2;
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    void insert(const Handle& entity) {
+        if (!entity) return;
+        reserve(used + 1);
+        const uint64_t hash = foldedNameHash(entity->getName());
+        Slot& slot = slots[probe(hash)];
+        if (!slot.entity) {
+            slot.hash = hash;
+            slot.entity = entity;
+            ++used;
+        } else if (!foldedNamesEqual(slot.entity->getName(), entity->getName())) {
+            collisions.push_back(entity);
+        }
+    }
+
+    Handle find(const std::string& name) const {
+        if (slots.empty()) return Handle{};
+        const Slot& slot = slots[probe(foldedNameHash(name))];
+        if (!slot.entity) return Handle{};
+        if (foldedNamesEqual(slot.entity->getName(), name)) return slot.entity;
+        for (const auto& e : collisions) {
+            if (foldedNamesEqual(e->getName(), name)) return e;
+        }
+        return Handle{};
+    }
+};
+
+#endif // NAME_INDEX_H
@@ -0,0 +1,65 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Handle to an interned name. Equal names always get the same id, so names
+// compare as integers.
+using NameId = uint32_t;
+
+constexpr NameId kNoName = 0xFFFFFFFFu;
+
+// Process-wide, append-only string interner for entity names (systems,
+// colonies, fleets, ships). Each distinct name is stored once; entities keep
+// its 4-byte id. Names are never removed or moved, so references returned by
+// get() stay valid, and get() may run on any thread while another interns.
+class NameTable {
+private:
+    // Segment k holds ids [kFirstSegment * (2^k - 1), kFirstSegment * (2^(k+1) - 1)),
+    // so the table grows without ever moving a stored string.
+    static constexpr std::size_t kFirstSegmentBits = 10;
+    static constexpr std::size_t kFirstSegment = std::size_t{1} << kFirstSegmentBits;
+    static constexpr std::size_t kSegmentCount = 33 - kFirstSegmentBits;
+
+    // Raw storage; only the first `count` strings are constructed, so
+    // untouched capacity never becomes resident.
+    std::array<std::string*, kSegmentCount> segments{};
+    std::atomic<uint32_t> count{0};
+    // Open-addressed hash, guarded by mutex. Each slot holds id + 1 in the low
+    // half (0 marks an empty slot) and the name's hash in the high half, so a
+    // probe only reads a stored string when the hashes match.
+    std::vector<uint64_t> slots;
+    mutable std::mutex mutex;
+
+    NameTable() = default;
+    ~NameTable();
+
+    std::string& slot(NameId id) const;
+    std::size_t probe(std::string_view name, uint32_t hash) const;
+    void grow();
+
+public:
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    static NameTable& global();
+
+    NameId intern(std::string_view name);
+    // kNoName if the name was never interned; does not add it.
+    NameId find(std::string_view name) const;
+    // Empty for kNoName.
+    const std::string& get(NameId id) const;
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+};
+
+inline NameId internName(std::string_view name) { return NameTable::global().intern(name); }
+inline const std::string& nameOf(NameId id) { return NameTable::global().get(id); }
+
+#endif // NAME_TABLE_H
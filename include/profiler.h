@@ -0,0 +1,56 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Runtime-switchable scoped timers. While disabled, a PROFILE_SCOPE costs one
+// relaxed load and a branch on entry and a test of a local on exit; nothing
+// is recorded. While enabled, each scope appends one complete event to a
+// per-thread buffer, and writeChromeTrace() dumps everything in the Chrome
+// trace_event format (open in chrome://tracing or Perfetto).
+class Profiler {
+private:
+    static std::atomic<bool> enabled;
+
+public:
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+    static int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // `name` must outlive the profiler (string literals).
+    static void record(const char* name, int64_t startNanos, int64_t endNanos);
+
+    // Call while no thread is inside a scope, e.g. between turns. Returns an
+    // empty string on success, otherwise an error message.
+    static std::string writeChromeTrace(const std::string& path);
+    static void clear();
+};
+
+class ProfileScope {
+private:
+    const char* name;
+    int64_t start;
+
+public:
+    explicit ProfileScope(const char* name) : name(name), start(Profiler::isEnabled() ? Profiler::nowNanos() : -1) {}
+    ~ProfileScope() {
+        if (start >= 0) Profiler::record(name, start, Profiler::nowNanos());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+#endif // PROFILER_H
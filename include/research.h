@@ -1,11 +1,13 @@
 #ifndef RESEARCH_H
 #define RESEARCH_H
 
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <map>
-#include <memory>
-#include <set>
+#include <optional>
 
 enum class TechCategory {
     PROPULSION,
@@ -30,61 +32,138 @@ enum class TechEra {
 std::string techCategoryToString(TechCategory cat);
 std::string techEraToString(TechEra era);
 
-class Technology {
-private:
-    std::string techId;
+// Capacity of the compiled tech tree; raise it if the catalogue outgrows it.
+constexpr std::size_t kMaxTechs = 128;
+
+// Dense tech id: the position of a tech in id order within the catalogue.
+using TechIndex = uint16_t;
+using TechMask = std::bitset<kMaxTechs>;
+
+// Static data for one technology. Never changes after the catalogue is built.
+struct TechDefinition {
+    std::string id;
     std::string name;
     TechCategory category;
     TechEra era;
     int cost;
     std::vector<std::string> prerequisites;
     std::string description;
-    bool researched;
-    int progress;
-
-public:
-    Technology(const std::string& id, const std::string& name, TechCategory cat,
-               TechEra era, int cost, const std::vector<std::string>& prereqs = {},
-               const std::string& desc = "");
-    
-    bool isAvailable(const std::set<std::string>& researchedTechs) const;
-    bool addProgress(int points);
-
-    void setProgressForLoad(int p);
-    void setResearchedForLoad(bool v);
-    
-    const std::string& getId() const { return techId; }
-    const std::string& getName() const { return name; }
-    TechCategory getCategory() const { return category; }
-    TechEra getEra() const { return era; }
-    int getCost() const { return cost; }
-    int getProgress() const { return progress; }
-    bool isResearched() const { return researched; }
-    const std::vector<std::string>& getPrerequisites() const { return prerequisites; }
 };
 
-class ResearchTree {
+// The immutable tech catalogue, built and compiled once and shared by every
+// ResearchTree: definitions are sorted by id and given dense indices, and each
+// prerequisite list becomes a TechMask.
+class TechCatalogue {
 private:
-    std::map<std::string, std::shared_ptr<Technology>> technologies;
-    std::set<std::string> researched;
-    
-    void initializeTechTree();
+    std::vector<TechDefinition> defs; // indexed by TechIndex
+    std::unordered_map<std::string, TechIndex> indexById;
+    std::vector<TechMask> prerequisiteMasks;
+    std::vector<TechMask> ancestorMasks;
+    std::vector<std::vector<TechIndex>> dependents;
+    std::vector<TechIndex> topologicalOrder;
+
+    TechCatalogue();
     void addTech(const std::string& id, const std::string& name, TechCategory cat,
                  TechEra era, int cost, const std::vector<std::string>& prereqs,
                  const std::string& desc);
+    void compile();
+    void compileAncestors();
+
+public:
+    // Built on first use; safe to call from any thread.
+    static const TechCatalogue& standard();
+    // Prerequisite bit standing in for a tech that can never be researched.
+    static TechMask unknownPrerequisite() { return TechMask().set(kMaxTechs - 1); }
+
+    std::size_t size() const { return defs.size(); }
+    const TechDefinition& get(TechIndex index) const { return defs[index]; }
+    const TechMask& prerequisites(TechIndex index) const { return prerequisiteMasks[index]; }
+    // Every tech that must be researched before `index`, transitively.
+    const TechMask& ancestors(TechIndex index) const { return ancestorMasks[index]; }
+    // Prerequisites before dependents; among ready techs, cheapest first.
+    const std::vector<TechIndex>& topologicalOrderOf() const { return topologicalOrder; }
+    const std::vector<TechIndex>& dependentsOf(TechIndex index) const { return dependents[index]; }
+    const TechIndex* findIndex(const std::string& techId) const;
+};
+
+class ResearchTree;
+
+// Lightweight view of one tech in one empire's tree: static data comes from
+// the shared catalogue, progress is read live from the tree.
+class Technology {
+private:
+    const ResearchTree* tree;
+    TechIndex index;
+
+public:
+    Technology(const ResearchTree& tree, TechIndex index) : tree(&tree), index(index) {}
+
+    const TechDefinition& definition() const;
+    TechIndex getIndex() const { return index; }
+    const std::string& getId() const { return definition().id; }
+    const std::string& getName() const { return definition().name; }
+    TechCategory getCategory() const { return definition().category; }
+    TechEra getEra() const { return definition().era; }
+    int getCost() const { return definition().cost; }
+    const std::vector<std::string>& getPrerequisites() const { return definition().prerequisites; }
+    const std::string& getDescription() const { return definition().description; }
+    int getProgress() const;
+    bool isResearched() const;
+};
+
+// Unresearched techs needed to reach a target, in an order that can be
+// researched front to back. Every prerequisite is mandatory, so this is also
+// the cheapest route. `totalCost` sums catalogue costs, ignoring partial progress.
+struct ResearchPlan {
+    std::vector<TechIndex> steps;
+    TechMask mask;
+    int totalCost = 0;
+};
+
+// One empire's research state. Only progress and the researched/available
+// bitsets are per-empire; everything static lives in the shared TechCatalogue.
+// `available` is updated incrementally when a tech completes, so availability
+// checks are a single bit test.
+class ResearchTree {
+private:
+    const TechCatalogue* catalogue;
+    std::vector<int> progress; // indexed by TechIndex
+    TechMask researched;
+    TechMask available;
+    // Plans by target; completing a tech just drops it from the plans that
+    // contain it.
+    mutable std::unordered_map<TechIndex, ResearchPlan> planCache;
+
+    bool prerequisitesMet(TechIndex index) const { return (catalogue->prerequisites(index) & ~researched).none(); }
+    void markResearched(TechIndex index);
+    void rebuildAvailable();
 
 public:
     ResearchTree();
-    
-    std::vector<std::shared_ptr<Technology>> getAvailableTechs() const;
-    std::vector<std::shared_ptr<Technology>> getAllTechs() const;
+
+    const TechCatalogue& getCatalogue() const { return *catalogue; }
+    std::vector<Technology> getAvailableTechs() const;
+    std::vector<Technology> getAllTechs() const;
     bool research(const std::string& techId, int points);
-    std::shared_ptr<Technology> getTech(const std::string& techId) const;
+    std::optional<Technology> getTech(const std::string& techId) const;
     bool isResearched(const std::string& techId) const;
-    int getResearchedCount() const { return static_cast<int>(researched.size()); }
+    bool isResearched(TechIndex index) const { return researched.test(index); }
+    // True if the tech exists, is unresearched and all its prerequisites are done.
+    bool isAvailable(const std::string& techId) const;
+    int getProgress(TechIndex index) const { return progress[index]; }
+    // Cheapest route to `techId`, ending with the tech itself; empty steps if it
+    // is already researched. Null if the tech is unknown or can never be
+    // researched. Valid until the next research change.
+    const ResearchPlan* planPathTo(const std::string& techId) const;
+    const ResearchPlan* planPathTo(TechIndex target) const;
+    int getResearchedCount() const { return static_cast<int>(researched.count()); }
+    int getAvailableCount() const { return static_cast<int>(available.count()); }
 
     void setTechStateForLoad(const std::string& techId, int progress, bool researchedFlag);
-    const std::set<std::string>& getResearchedSetForLoad() const { return researched; }
 };
 
+inline const TechDefinition& Technology::definition() const { return tree->getCatalogue().get(index); }
+inline int Technology::getProgress() const { return tree->getProgress(index); }
+inline bool Technology::isResearched() const { return tree->isResearched(index); }
+
 #endif // RESEARCH_H
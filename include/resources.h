@@ -1,8 +1,13 @@
 #ifndef RESOURCES_H
 #define RESOURCES_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
-#include <map>
+#include <string_view>
+#include <utility>
 
 enum class ResourceType {
     MINERALS,
@@ -22,13 +27,60 @@ enum class ResourceType {
     GALLICITE
 };
 
+constexpr std::size_t kResourceTypeCount = static_cast<std::size_t>(ResourceType::GALLICITE) + 1;
+
 std::string resourceTypeToString(ResourceType type);
-bool resourceTypeFromString(const std::string& s, ResourceType& out);
+bool resourceTypeFromString(std::string_view s, ResourceType& out);
+
+// One int per ResourceType in a flat array, zero meaning none. The array is
+// padded to 16 lanes (64 bytes) so the element-wise loops below compile to a
+// few full-width vector operations with no remainder handling.
+class ResourceAmounts {
+private:
+    static constexpr std::size_t kLanes = 16;
+    static_assert(kResourceTypeCount <= kLanes, "ResourceAmounts lanes must cover every ResourceType");
+
+    // Lanes past kResourceTypeCount always stay zero.
+    alignas(64) std::array<int32_t, kLanes> values{};
+
+public:
+    ResourceAmounts() = default;
+    ResourceAmounts(std::initializer_list<std::pair<ResourceType, int>> amounts) {
+        for (const auto& a : amounts) (*this)[a.first] = a.second;
+    }
+
+    int32_t& operator[](ResourceType type) { return values[static_cast<std::size_t>(type)]; }
+    int32_t operator[](ResourceType type) const { return values[static_cast<std::size_t>(type)]; }
+    int32_t operator[](std::size_t index) const { return values[index]; }
+
+    ResourceAmounts& operator+=(const ResourceAmounts& other) {
+        for (std::size_t i = 0; i < kLanes; ++i) values[i] += other.values[i];
+        return *this;
+    }
+
+    ResourceAmounts& operator-=(const ResourceAmounts& other) {
+        for (std::size_t i = 0; i < kLanes; ++i) values[i] -= other.values[i];
+        return *this;
+    }
+
+    // this += other * times
+    void addScaled(const ResourceAmounts& other, int times) {
+        for (std::size_t i = 0; i < kLanes; ++i) values[i] += other.values[i] * times;
+    }
+
+    // True when every amount in `cost` is available here. Zero entries are
+    // not checked, like types left out of a cost list.
+    bool covers(const ResourceAmounts& cost) const {
+        bool ok = true;
+        for (std::size_t i = 0; i < kLanes; ++i) ok &= (cost.values[i] == 0) | (values[i] >= cost.values[i]);
+        return ok;
+    }
+};
 
 class ResourceStorage {
 private:
-    std::map<ResourceType, int> resources;
-    std::map<ResourceType, int> productionRates;
+    ResourceAmounts resources;
+    ResourceAmounts productionRates;
 
 public:
     ResourceStorage();
@@ -38,10 +90,10 @@ public:
     void set(ResourceType type, int amount);
     bool consume(ResourceType type, int amount);
     void produce(int turns = 1);
-    bool canAfford(const std::map<ResourceType, int>& costs) const;
-    bool payCosts(const std::map<ResourceType, int>& costs);
+    bool canAfford(const ResourceAmounts& costs) const;
+    bool payCosts(const ResourceAmounts& costs);
 
-    const std::map<ResourceType, int>& snapshot() const { return resources; }
+    const ResourceAmounts& snapshot() const { return resources; }
 };
 
 class ResourceNode {
@@ -0,0 +1,98 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Subsystems that draw random numbers. Each gets its own independent stream so
+// that adding draws in one subsystem never shifts the sequence seen by another.
+enum class RngStreamId : uint32_t {
+    COMBAT,
+    AI_TURN,
+    PREDICTION,
+    COUNT
+};
+
+std::string rngStreamToString(RngStreamId id);
+bool rngStreamFromString(std::string_view s, RngStreamId& out);
+
+// SplitMix64 finalizer; a strong 64-bit mixing function.
+inline uint64_t rngMix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Derives an independent stream key from a seed and up to two indices.
+inline uint64_t rngDeriveKey(uint64_t seed, uint64_t a, uint64_t b = 0) {
+    uint64_t k = rngMix64(seed + 0x9E3779B97F4A7C15ULL);
+    k = rngMix64(k ^ (a + 0xD1B54A32D192ED03ULL));
+    return rngMix64(k ^ (b + 0x8CB92BA72F3D8DD7ULL));
+}
+
+// Counter-based random stream: output n is a pure function of (key, n), so a
+// stream is just two integers and can be saved, restored or forked for free.
+// Satisfies UniformRandomBitGenerator, but the helpers below are preferred
+// because std distributions are not reproducible across standard libraries.
+class RandomStream {
+private:
+    uint64_t key;
+    uint64_t counter;
+
+public:
+    using result_type = uint64_t;
+
+    explicit RandomStream(uint64_t key = 0, uint64_t counter = 0) : key(key), counter(counter) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    result_type operator()() { return rngMix64(key + (++counter) * 0x9E3779B97F4A7C15ULL); }
+
+    // Uniform double in [0, 1).
+    double uniform01() { return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+    bool chance(double p) { return uniform01() < p; }
+
+    // Uniform integer in [0, n); n must be non-zero and fit in 32 bits.
+    std::size_t below(std::size_t n) {
+        const uint64_t r = (*this)() >> 32;
+        return static_cast<std::size_t>((r * static_cast<uint64_t>(n)) >> 32);
+    }
+
+    // Uniform integer in [lo, hi].
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(below(static_cast<std::size_t>(static_cast<int64_t>(hi) - lo + 1)));
+    }
+
+    uint64_t getKey() const { return key; }
+    uint64_t getCounter() const { return counter; }
+    void setCounter(uint64_t c) { counter = c; }
+};
+
+// Per-game RNG service: one stream per subsystem, all derived from one seed.
+class RngService {
+private:
+    uint64_t seed;
+    std::array<RandomStream, static_cast<std::size_t>(RngStreamId::COUNT)> streams;
+
+public:
+    explicit RngService(uint64_t seed = 0);
+
+    // Resets every stream to the start of its sequence for the given seed.
+    void reseed(uint64_t newSeed);
+
+    RandomStream& stream(RngStreamId id) { return streams[static_cast<std::size_t>(id)]; }
+    const RandomStream& stream(RngStreamId id) const { return streams[static_cast<std::size_t>(id)]; }
+
+    // An independent stream keyed by (seed, id, index) that does not advance
+    // the subsystem stream; used for parallel work that must not depend on
+    // scheduling order.
+    RandomStream fork(RngStreamId id, uint64_t index) const;
+
+    uint64_t getSeed() const { return seed; }
+};
+
+#endif // RNG_H
@@ -0,0 +1,93 @@
+#ifndef SAVE_GAME_H
+#define SAVE_GAME_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "combat.h"
+#include "galaxy.h"
+#include "name_table.h"
+#include "resources.h"
+#include "rng.h"
+
+// Plain-value image of a saved game. Game fills one to save and rebuilds
+// itself from one on load; the on-disk formats only read and write this.
+
+// Entity names are interned (see name_table.h), so capturing a game copies
+// ids rather than strings; kNoName stands for an empty name.
+
+struct SavedShip {
+    NameId name{kNoName};
+    ShipClass cls{ShipClass::SCOUT};
+    int hull{0};
+    int shields{0};
+};
+
+struct SavedFleet {
+    NameId name{kNoName};
+    NameId system{kNoName};
+    std::vector<SavedShip> ships;
+};
+
+struct SavedColony {
+    NameId name{kNoName};
+    NameId system{kNoName};
+    NameId planet{kNoName};
+    int pop{10};
+    int mines{0};
+    int factories{0};
+};
+
+struct SavedTech {
+    std::string id;
+    int progress{0};
+    bool researched{false};
+};
+
+struct SavedEmpire {
+    std::string name;
+    int turn{0};
+    std::string currentResearch;
+    std::vector<std::pair<ResourceType, int>> resources;
+    std::vector<SavedTech> techs;
+    std::vector<SavedColony> colonies;
+    std::vector<SavedFleet> fleets;
+};
+
+struct SavedHostile {
+    SavedEmpire e;
+    bool contacted{false};
+    bool atWar{false};
+};
+
+struct SaveData {
+    uint32_t seed{0};
+    int numSystems{20};
+    // Saves from before the generator was recorded were all sequential.
+    GalaxyGenerator galaxyGenerator{GalaxyGenerator::SEQUENTIAL_MT19937};
+    bool haveRngState{false};
+    uint64_t rngSeed{0};
+    std::vector<std::pair<RngStreamId, uint64_t>> rngCounters;
+    std::vector<NameId> exploredSystems;
+    SavedEmpire player;
+    std::vector<SavedHostile> hostiles;
+};
+
+enum class SaveFormat {
+    // Line-oriented "AURORA_SAVE_V1" text; human-readable.
+    TEXT_V1,
+    // "AURORA_SAVE_V2": fixed-width little-endian records plus a string table,
+    // loaded through a memory map.
+    BINARY_V2
+};
+
+// Both return an empty string on success, otherwise an error message.
+std::string writeSaveFile(const SaveData& data, const std::string& path, SaveFormat format);
+// Writes "<path>.tmp", flushes it to disk and renames it over `path`, so a
+// crash at any point leaves either the previous file or the new one intact.
+std::string writeSaveFileAtomic(const SaveData& data, const std::string& path, SaveFormat format);
+// Detects the format from the file header.
+std::string readSaveFile(const std::string& path, SaveData& out);
+
+#endif // SAVE_GAME_H
@@ -0,0 +1,25 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+
+// Non-owning view of contiguous elements, for C++17 (std::span is C++20).
+template <typename T>
+class Span {
+private:
+    T* first = nullptr;
+    std::size_t count = 0;
+
+public:
+    Span() = default;
+    Span(T* first, std::size_t count) : first(first), count(count) {}
+
+    T* begin() const { return first; }
+    T* end() const { return first + count; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](std::size_t i) const { return first[i]; }
+    T& front() const { return first[0]; }
+};
+
+#endif // SPAN_H
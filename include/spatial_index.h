@@ -0,0 +1,51 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SpatialPoint {
+    int x;
+    int y;
+    int z;
+};
+
+// Static 3D k-d tree over integer points. Built once in O(n log n); answers
+// radius, k-nearest and box queries in O(log n + results) on average. Query
+// results are indices into the point list given to build().
+class SpatialIndex {
+private:
+    struct Node {
+        int32_t x, y, z;
+        uint32_t index;
+    };
+
+    // Implicit balanced tree: the node for range [lo, hi) sits at the midpoint,
+    // split on axis depth % 3.
+    std::vector<Node> nodes;
+
+    void buildRange(std::size_t lo, std::size_t hi, int depth);
+    void radiusRange(std::size_t lo, std::size_t hi, int depth, const Node& c, int64_t r2,
+                     std::vector<std::size_t>& out) const;
+    void boxRange(std::size_t lo, std::size_t hi, int depth, const Node& minC, const Node& maxC,
+                  std::vector<std::size_t>& out) const;
+    template <typename Heap>
+    void nearestRange(std::size_t lo, std::size_t hi, int depth, const Node& c, std::size_t k, Heap& heap) const;
+
+public:
+    void build(const std::vector<SpatialPoint>& points);
+
+    std::size_t size() const { return nodes.size(); }
+
+    // Points within Euclidean distance `radius` (inclusive), in index order.
+    std::vector<std::size_t> withinRadius(int x, int y, int z, double radius) const;
+
+    // Up to k points closest to (x, y, z), nearest first; ties by index.
+    std::vector<std::size_t> nearest(int x, int y, int z, std::size_t k) const;
+
+    // Points inside the inclusive box [min, max] on every axis, in index order.
+    std::vector<std::size_t> inBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ) const;
+};
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,42 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool for data-parallel loops.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    void workerLoop();
+    void post(std::function<void()> task);
+
+public:
+    // threads == 0 uses one thread per hardware core.
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that run work, counting the caller of parallelFor().
+    std::size_t size() const { return workers.size() + 1; }
+
+    // Calls fn(begin, end) over contiguous chunks covering [0, count) and
+    // blocks until all chunks are done. The calling thread takes chunks too,
+    // so nested calls from inside a chunk cannot deadlock.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& fn,
+                     std::size_t minChunk = 1);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,73 @@
+#include "autosave.h"
+#include "profiler.h"
+
+#include <utility>
+
+AutosaveWriter::AutosaveWriter()
+    : pending{nullptr, std::string(), SaveFormat::TEXT_V1},
+      busy(false),
+      stopping(false),
+      completed(0) {
+    worker = std::thread([this] { workerLoop(); });
+}
+
+AutosaveWriter::~AutosaveWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void AutosaveWriter::submit(SaveData snapshot, const std::string& path, SaveFormat format) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.snapshot = std::make_unique<const SaveData>(std::move(snapshot));
+        pending.path = path;
+        pending.format = format;
+    }
+    wake.notify_one();
+}
+
+void AutosaveWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !pending.snapshot && !busy; });
+}
+
+int AutosaveWriter::getCompletedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed;
+}
+
+std::string AutosaveWriter::getLastResult() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastResult;
+}
+
+void AutosaveWriter::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || pending.snapshot; });
+        if (!pending.snapshot) return; // stopping with nothing left to write
+
+        Job job = std::move(pending);
+        pending.snapshot.reset();
+        busy = true;
+        lock.unlock();
+
+        std::string result;
+        {
+            PROFILE_SCOPE("Autosave write");
+            result = writeSaveFileAtomic(*job.snapshot, job.path, job.format);
+        }
+        if (result.empty()) result = "Saved to " + job.path;
+        job.snapshot.reset();
+
+        lock.lock();
+        busy = false;
+        completed++;
+        lastResult = std::move(result);
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#include "battle_predictor.h"
+#include "combat_kernel.h"
+#include "rng.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+struct TrialTotals {
+    long long attackerWins = 0;
+    long long attackerLosses = 0;
+    long long defenderLosses = 0;
+    std::array<int, BattlePrediction::kHistogramBuckets> attackerHistogram{};
+    std::array<int, BattlePrediction::kHistogramBuckets> defenderHistogram{};
+};
+
+static int damageBucket(int taken, int total) {
+    if (total <= 0) return 0;
+    const int bucket = static_cast<int>((static_cast<long long>(taken) * BattlePrediction::kHistogramBuckets) / total);
+    return std::max(0, std::min(bucket, BattlePrediction::kHistogramBuckets - 1));
+}
+} // namespace
+
+BattlePrediction predictBattleOutcome(const Fleet& attacker, const Fleet& defender, int samples,
+                                      int maxRounds, uint64_t seed, ThreadPool& pool) {
+    BattlePrediction result;
+    if (samples <= 0) return result;
+
+    // One snapshot of both fleets; each chunk copies it once and resets it per trial.
+    const CombatKernel snapshot(attacker, defender);
+    const int attackerTotal = snapshot.getStartTotal(CombatSide::ATTACKER);
+    const int defenderTotal = snapshot.getStartTotal(CombatSide::DEFENDER);
+    const long long attackerShips = static_cast<long long>(snapshot.aliveCount(CombatSide::ATTACKER));
+    const long long defenderShips = static_cast<long long>(snapshot.aliveCount(CombatSide::DEFENDER));
+
+    TrialTotals totals;
+    std::mutex totalsMutex;
+
+    pool.parallelFor(static_cast<std::size_t>(samples), [&](std::size_t begin, std::size_t end) {
+        CombatKernel kernel = snapshot;
+        TrialTotals local;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (i != begin) kernel.reset();
+            RandomStream rng(rngDeriveKey(seed, i));
+            const auto outcome = kernel.resolve(rng, maxRounds);
+
+            if (outcome.winner == CombatSide::ATTACKER) local.attackerWins++;
+            local.attackerLosses += attackerShips - static_cast<long long>(kernel.aliveCount(CombatSide::ATTACKER));
+            local.defenderLosses += defenderShips - static_cast<long long>(kernel.aliveCount(CombatSide::DEFENDER));
+            local.attackerHistogram[damageBucket(kernel.getDamageTaken(CombatSide::ATTACKER), attackerTotal)]++;
+            local.defenderHistogram[damageBucket(kernel.getDamageTaken(CombatSide::DEFENDER), defenderTotal)]++;
+        }
+
+        // Integer sums, so merge order does not affect the result.
+        std::lock_guard<std::mutex> lock(totalsMutex);
+        totals.attackerWins += local.attackerWins;
+        totals.attackerLosses += local.attackerLosses;
+        totals.defenderLosses += local.defenderLosses;
+        for (int b = 0; b < BattlePrediction::kHistogramBuckets; ++b) {
+            totals.attackerHistogram[b] += local.attackerHistogram[b];
+            totals.defenderHistogram[b] += local.defenderHistogram[b];
+        }
+    }, 64);
+
+    const double n = static_cast<double>(samples);
+    result.samples = samples;
+    result.attackerWinProbability = static_cast<double>(totals.attackerWins) / n;
+    result.expectedAttackerLosses = static_cast<double>(totals.attackerLosses) / n;
+    result.expectedDefenderLosses = static_cast<double>(totals.defenderLosses) / n;
+    result.attackerDamageHistogram = totals.attackerHistogram;
+    result.defenderDamageHistogram = totals.defenderHistogram;
+    return result;
+}
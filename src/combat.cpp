@@ -1,7 +1,8 @@
 #include "combat.h"
+#include "name_index.h"
+#include "profiler.h"
 #include <algorithm>
 #include <cctype>
-#include <random>
 #include <sstream>
 
 namespace {
@@ -31,23 +32,23 @@ static std::string makeBar(int value, int maxValue, int width) {
     return bar;
 }
 
-static void appendFleetSnapshot(std::vector<std::string>& log, const Fleet& fleet) {
+static void appendFleetSnapshot(std::vector<std::string>& log, const std::string& fleetName,
+                                const std::vector<CombatShipState>& ships) {
     int totalHull = 0;
     int totalMaxHull = 0;
     int totalShields = 0;
     int totalMaxShields = 0;
 
-    for (const auto& ship : fleet.getShips()) {
-        if (!ship) continue;
-        totalHull += ship->getHull();
-        totalMaxHull += ship->getMaxHull();
-        totalShields += ship->getShields();
-        totalMaxShields += ship->getMaxShields();
+    for (const auto& ship : ships) {
+        totalHull += ship.hull;
+        totalMaxHull += ship.maxHull;
+        totalShields += ship.shields;
+        totalMaxShields += ship.maxShields;
     }
 
     {
         std::ostringstream ss;
-        ss << fleet.getName() << " | Ships: " << fleet.getShips().size()
+        ss << fleetName << " | Ships: " << ships.size()
            << " | Hull " << totalHull << "/" << totalMaxHull
            << " [" << makeBar(totalHull, totalMaxHull, 20) << "]"
            << " | Shields " << totalShields << "/" << totalMaxShields
@@ -55,14 +56,13 @@ static void appendFleetSnapshot(std::vector<std::string>& log, const Fleet& flee
         log.push_back(ss.str());
     }
 
-    for (const auto& ship : fleet.getShips()) {
-        if (!ship) continue;
+    for (const auto& ship : ships) {
         std::ostringstream ss;
-        ss << "  - " << ship->getName() << " (" << shipClassToString(ship->getShipClass()) << ")"
-           << " H " << ship->getHull() << "/" << ship->getMaxHull()
-           << " [" << makeBar(ship->getHull(), ship->getMaxHull(), 12) << "]"
-           << " S " << ship->getShields() << "/" << ship->getMaxShields()
-           << " [" << makeBar(ship->getShields(), ship->getMaxShields(), 12) << "]";
+        ss << "  - " << ship.name << " (" << shipClassToString(ship.shipClass) << ")"
+           << " H " << ship.hull << "/" << ship.maxHull
+           << " [" << makeBar(ship.hull, ship.maxHull, 12) << "]"
+           << " S " << ship.shields << "/" << ship.maxShields
+           << " [" << makeBar(ship.shields, ship.maxShields, 12) << "]";
         log.push_back(ss.str());
     }
 }
@@ -81,41 +81,30 @@ std::string shipClassToString(ShipClass sc) {
     }
 }
 
-static std::string toLower(std::string s) {
-    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return s;
-}
-
-bool shipClassFromString(const std::string& s, ShipClass& out) {
-    const std::string v = toLower(s);
-    if (v == "scout") { out = ShipClass::SCOUT; return true; }
-    if (v == "fighter") { out = ShipClass::FIGHTER; return true; }
-    if (v == "corvette") { out = ShipClass::CORVETTE; return true; }
-    if (v == "frigate") { out = ShipClass::FRIGATE; return true; }
-    if (v == "destroyer") { out = ShipClass::DESTROYER; return true; }
-    if (v == "cruiser") { out = ShipClass::CRUISER; return true; }
-    if (v == "battleship") { out = ShipClass::BATTLESHIP; return true; }
-    if (v == "carrier") { out = ShipClass::CARRIER; return true; }
+bool shipClassFromString(std::string_view s, ShipClass& out) {
+    if (foldedNamesEqual(s, "scout")) { out = ShipClass::SCOUT; return true; }
+    if (foldedNamesEqual(s, "fighter")) { out = ShipClass::FIGHTER; return true; }
+    if (foldedNamesEqual(s, "corvette")) { out = ShipClass::CORVETTE; return true; }
+    if (foldedNamesEqual(s, "frigate")) { out = ShipClass::FRIGATE; return true; }
+    if (foldedNamesEqual(s, "destroyer")) { out = ShipClass::DESTROYER; return true; }
+    if (foldedNamesEqual(s, "cruiser")) { out = ShipClass::CRUISER; return true; }
+    if (foldedNamesEqual(s, "battleship")) { out = ShipClass::BATTLESHIP; return true; }
+    if (foldedNamesEqual(s, "carrier")) { out = ShipClass::CARRIER; return true; }
     return false;
 }
 
 Weapon::Weapon(const std::string& nm, int dmg, double acc, int rng)
     : name(nm), damage(dmg), accuracy(acc), range(rng) {}
 
-int Weapon::fire() const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    
-    if (dis(gen) < accuracy) {
+int Weapon::fire(RandomStream& rng) const {
+    if (rng.uniform01() < accuracy) {
         return damage;
     }
     return 0;
 }
 
-Ship::Ship(const std::string& nm, ShipClass sc, int hll, int shlds,
-           const std::vector<Weapon>& wpns)
-    : name(nm), shipClass(sc), maxHull(hll), hull(hll),
+Ship::Ship(NameId nm, ShipClass sc, int hll, int shlds, const std::vector<Weapon>& wpns)
+    : id(kNoEntity), name(nm), shipClass(sc), maxHull(hll), hull(hll),
       maxShields(shlds), shields(shlds), weapons(wpns), destroyed(false) {}
 
 void Ship::takeDamage(int damage) {
@@ -136,16 +125,16 @@ void Ship::takeDamage(int damage) {
     }
 }
 
-int Ship::fireAt() {
+int Ship::fireAt(RandomStream& rng) {
     int totalDamage = 0;
     for (const auto& weapon : weapons) {
-        totalDamage += weapon.fire();
+        totalDamage += weapon.fire(rng);
     }
     return totalDamage;
 }
 
-Fleet::Fleet(const std::string& nm, const std::string& own)
-    : name(nm), owner(own) {}
+Fleet::Fleet(NameId nm, EmpireId own, FleetId fid)
+    : id(fid), name(nm), owner(own), location(kNoEntity) {}
 
 void Fleet::addShip(std::shared_ptr<Ship> ship) {
     ships.push_back(ship);
@@ -174,8 +163,9 @@ bool Fleet::isDefeated() const {
                       [](const std::shared_ptr<Ship>& ship) { return !ship->isOperational(); });
 }
 
-Combat::Combat(std::shared_ptr<Fleet> atk, std::shared_ptr<Fleet> def)
-    : attacker(atk), defender(def), round(0) {}
+Combat::Combat(std::shared_ptr<Fleet> atk, std::shared_ptr<Fleet> def, RandomStream& rng,
+               CombatRecording recording)
+    : attacker(atk), defender(def), recording(recording), logRendered(false), round(0), rng(rng) {}
 
 void Combat::recordFrame() {
     CombatFrame f;
@@ -199,75 +189,57 @@ void Combat::recordFrame() {
     frames.push_back(std::move(f));
 }
 
-void Combat::resolveRound() {
-    round++;
-    std::stringstream ss;
-    ss << "=== Combat Round " << round << " ===";
-    combatLog.push_back(ss.str());
+void Combat::recordEvent(CombatEvent::Kind kind, const Ship* actor, const Ship* target, int value, int value2) {
+    if (recording == CombatRecording::NONE) return;
+    events.push_back(CombatEvent{kind, round, actor, target, value, value2});
+    logRendered = false;
+}
 
-    const int atkShipsBefore = attacker ? static_cast<int>(attacker->getShips().size()) : 0;
-    const int defShipsBefore = defender ? static_cast<int>(defender->getShips().size()) : 0;
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    
-    // Attacker fires
-    for (auto& ship : attacker->getShips()) {
-        if (ship->isOperational() && !defender->getShips().empty()) {
+void Combat::fireVolley(Fleet& shooters, Fleet& targets) {
+    for (auto& ship : shooters.getShips()) {
+        if (ship->isOperational() && !targets.getShips().empty()) {
             std::vector<std::shared_ptr<Ship>> operationalTargets;
-            for (auto& target : defender->getShips()) {
+            for (auto& target : targets.getShips()) {
                 if (target->isOperational()) {
                     operationalTargets.push_back(target);
                 }
             }
             
             if (!operationalTargets.empty()) {
-                std::uniform_int_distribution<std::size_t> dis(0, operationalTargets.size() - 1);
-                auto target = operationalTargets[dis(gen)];
+                auto target = operationalTargets[rng.below(operationalTargets.size())];
                 
-                int damage = ship->fireAt();
+                int damage = ship->fireAt(rng);
                 if (damage > 0) {
                     target->takeDamage(damage);
-                    std::stringstream log;
-                    log << ship->getName() << " hits " << target->getName() << " for " << damage << " damage";
-                    combatLog.push_back(log.str());
+                    recordEvent(CombatEvent::Kind::HIT, ship.get(), target.get(), damage);
                     
                     if (!target->isOperational()) {
-                        combatLog.push_back(target->getName() + " destroyed!");
+                        recordEvent(CombatEvent::Kind::DESTROYED, nullptr, target.get());
                     }
                 }
             }
         }
     }
-    
-    // Defender fires back
-    for (auto& ship : defender->getShips()) {
-        if (ship->isOperational() && !attacker->getShips().empty()) {
-            std::vector<std::shared_ptr<Ship>> operationalTargets;
-            for (auto& target : attacker->getShips()) {
-                if (target->isOperational()) {
-                    operationalTargets.push_back(target);
-                }
-            }
-            
-            if (!operationalTargets.empty()) {
-                std::uniform_int_distribution<std::size_t> dis(0, operationalTargets.size() - 1);
-                auto target = operationalTargets[dis(gen)];
-                
-                int damage = ship->fireAt();
-                if (damage > 0) {
-                    target->takeDamage(damage);
-                    std::stringstream log;
-                    log << ship->getName() << " hits " << target->getName() << " for " << damage << " damage";
-                    combatLog.push_back(log.str());
-                    
-                    if (!target->isOperational()) {
-                        combatLog.push_back(target->getName() + " destroyed!");
-                    }
-                }
-            }
-        }
+}
+
+void Combat::resolveRound() {
+    PROFILE_SCOPE("Combat::resolveRound");
+    // Events refer to ships by pointer; the roster keeps destroyed ships alive
+    // until the log has been rendered.
+    if (recording != CombatRecording::NONE && roster.empty()) {
+        roster.insert(roster.end(), attacker->getShips().begin(), attacker->getShips().end());
+        roster.insert(roster.end(), defender->getShips().begin(), defender->getShips().end());
     }
+
+    round++;
+    recordEvent(CombatEvent::Kind::ROUND_START);
+
+    const int atkShipsBefore = attacker ? static_cast<int>(attacker->getShips().size()) : 0;
+    const int defShipsBefore = defender ? static_cast<int>(defender->getShips().size()) : 0;
+    
+    // Attacker fires, then defender fires back
+    fireVolley(*attacker, *defender);
+    fireVolley(*defender, *attacker);
     
     // Remove destroyed ships
     attacker->removeDestroyed();
@@ -275,36 +247,33 @@ void Combat::resolveRound() {
 
     const int atkShipsAfter = attacker ? static_cast<int>(attacker->getShips().size()) : 0;
     const int defShipsAfter = defender ? static_cast<int>(defender->getShips().size()) : 0;
-    {
-        std::ostringstream sum;
-        sum << "Round " << round << " summary: "
-            << attacker->getName() << " lost " << std::max(0, atkShipsBefore - atkShipsAfter)
-            << ", " << defender->getName() << " lost " << std::max(0, defShipsBefore - defShipsAfter) << ".";
-        combatLog.push_back(sum.str());
-    }
-
-    // "Visualization": append a compact status snapshot after the round
-    combatLog.push_back("--- Status ---");
-    appendFleetSnapshot(combatLog, *attacker);
-    appendFleetSnapshot(combatLog, *defender);
+    recordEvent(CombatEvent::Kind::ROUND_SUMMARY, nullptr, nullptr,
+                std::max(0, atkShipsBefore - atkShipsAfter), std::max(0, defShipsBefore - defShipsAfter));
 
-    recordFrame();
+    if (recording == CombatRecording::FULL) {
+        // "Visualization": a compact status snapshot after the round, rendered from the frame.
+        recordEvent(CombatEvent::Kind::STATUS, nullptr, nullptr, static_cast<int>(frames.size()));
+        recordFrame();
+    }
 }
 
 std::shared_ptr<Fleet> Combat::resolve(int maxRounds) {
-    combatLog.clear();
+    events.clear();
+    roster.clear();
     frames.clear();
+    combatLog.clear();
+    logRendered = false;
     round = 0;
-    recordFrame();
+    if (recording == CombatRecording::FULL) recordFrame();
 
     while (round < maxRounds) {
         resolveRound();
         
         if (attacker->isDefeated()) {
-            combatLog.push_back(defender->getName() + " wins!");
+            recordEvent(CombatEvent::Kind::VICTORY, nullptr, nullptr, 0, 0);
             return defender;
         } else if (defender->isDefeated()) {
-            combatLog.push_back(attacker->getName() + " wins!");
+            recordEvent(CombatEvent::Kind::VICTORY, nullptr, nullptr, 0, 1);
             return attacker;
         }
     }
@@ -314,10 +283,59 @@ std::shared_ptr<Fleet> Combat::resolve(int maxRounds) {
     int defenderStrength = defender->getCombatStrength();
     
     if (attackerStrength > defenderStrength) {
-        combatLog.push_back(attacker->getName() + " wins by attrition!");
+        recordEvent(CombatEvent::Kind::VICTORY, nullptr, nullptr, 1, 1);
         return attacker;
     } else {
-        combatLog.push_back(defender->getName() + " wins by attrition!");
+        recordEvent(CombatEvent::Kind::VICTORY, nullptr, nullptr, 1, 0);
         return defender;
     }
 }
+
+const std::vector<std::string>& Combat::getLog() const {
+    if (!logRendered) {
+        renderLog();
+        logRendered = true;
+    }
+    return combatLog;
+}
+
+void Combat::renderLog() const {
+    combatLog.clear();
+    combatLog.reserve(events.size());
+
+    for (const auto& ev : events) {
+        switch (ev.kind) {
+            case CombatEvent::Kind::ROUND_START:
+                combatLog.push_back("=== Combat Round " + std::to_string(ev.round) + " ===");
+                break;
+            case CombatEvent::Kind::HIT:
+                combatLog.push_back(ev.actor->getName() + " hits " + ev.target->getName() + " for " +
+                                    std::to_string(ev.value) + " damage");
+                break;
+            case CombatEvent::Kind::DESTROYED:
+                combatLog.push_back(ev.target->getName() + " destroyed!");
+                break;
+            case CombatEvent::Kind::ROUND_SUMMARY: {
+                std::ostringstream sum;
+                sum << "Round " << ev.round << " summary: "
+                    << attacker->getName() << " lost " << ev.value
+                    << ", " << defender->getName() << " lost " << ev.value2 << ".";
+                combatLog.push_back(sum.str());
+                break;
+            }
+            case CombatEvent::Kind::STATUS: {
+                if (ev.value < 0 || ev.value >= static_cast<int>(frames.size())) break;
+                const CombatFrame& f = frames[static_cast<std::size_t>(ev.value)];
+                combatLog.push_back("--- Status ---");
+                appendFleetSnapshot(combatLog, f.attackerName, f.attackerShips);
+                appendFleetSnapshot(combatLog, f.defenderName, f.defenderShips);
+                break;
+            }
+            case CombatEvent::Kind::VICTORY: {
+                const std::string& winner = ev.value2 ? attacker->getName() : defender->getName();
+                combatLog.push_back(winner + (ev.value ? " wins by attrition!" : " wins!"));
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#include "combat_kernel.h"
+#include <algorithm>
+#include <cstddef>
+
+CombatKernel::CombatKernel(const Fleet& attacker, const Fleet& defender) {
+    load(attacker, defender);
+}
+
+void CombatKernel::loadSide(SideState& st, const Fleet& fleet) {
+    st = SideState{};
+
+    const auto& ships = fleet.getShips();
+    st.hull.reserve(ships.size());
+    st.shields.reserve(ships.size());
+    st.weaponBegin.reserve(ships.size() + 1);
+    st.alive.reserve(ships.size());
+
+    for (const auto& ship : ships) {
+        if (!ship) continue;
+        const uint32_t i = static_cast<uint32_t>(st.hull.size());
+        st.hull.push_back(ship->getHull());
+        st.shields.push_back(ship->getShields());
+        st.weaponBegin.push_back(static_cast<uint32_t>(st.weaponDamage.size()));
+        for (const auto& w : ship->getWeapons()) {
+            st.weaponDamage.push_back(w.getDamage());
+            st.weaponAccuracy.push_back(w.getAccuracy());
+        }
+        if (ship->isOperational()) st.alive.push_back(i);
+    }
+    st.weaponBegin.push_back(static_cast<uint32_t>(st.weaponDamage.size()));
+    st.startHull = st.hull;
+    st.startShields = st.shields;
+}
+
+void CombatKernel::load(const Fleet& attacker, const Fleet& defender) {
+    loadSide(sides[index(CombatSide::ATTACKER)], attacker);
+    loadSide(sides[index(CombatSide::DEFENDER)], defender);
+}
+
+void CombatKernel::resetSide(SideState& st) {
+    st.hull = st.startHull;
+    st.shields = st.startShields;
+    st.alive.clear();
+    for (std::size_t i = 0; i < st.hull.size(); ++i) {
+        if (st.hull[i] > 0) st.alive.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void CombatKernel::reset() {
+    resetSide(sides[index(CombatSide::ATTACKER)]);
+    resetSide(sides[index(CombatSide::DEFENDER)]);
+}
+
+void CombatKernel::fireVolley(const SideState& shooters, SideState& targets, RandomStream& rng) {
+    // Shooters cannot be hit during their own volley, so their alive list is stable.
+    for (const uint32_t s : shooters.alive) {
+        if (targets.alive.empty()) return;
+
+        const std::size_t slot = rng.below(targets.alive.size());
+        const uint32_t t = targets.alive[slot];
+
+        int damage = 0;
+        for (uint32_t w = shooters.weaponBegin[s]; w < shooters.weaponBegin[s + 1]; ++w) {
+            if (rng.uniform01() < shooters.weaponAccuracy[w]) damage += shooters.weaponDamage[w];
+        }
+        if (damage <= 0) continue;
+
+        // Shields absorb first, same as Ship::takeDamage().
+        const int absorbed = std::min(targets.shields[t], damage);
+        targets.shields[t] -= absorbed;
+        damage -= absorbed;
+        if (damage > 0) {
+            targets.hull[t] -= damage;
+            if (targets.hull[t] <= 0) {
+                targets.hull[t] = 0;
+                targets.alive.erase(targets.alive.begin() + static_cast<std::ptrdiff_t>(slot));
+            }
+        }
+    }
+}
+
+void CombatKernel::resolveRound(RandomStream& rng) {
+    SideState& atk = sides[index(CombatSide::ATTACKER)];
+    SideState& def = sides[index(CombatSide::DEFENDER)];
+    fireVolley(atk, def, rng);
+    fireVolley(def, atk, rng);
+}
+
+int CombatKernel::getStrength(CombatSide side) const {
+    const SideState& st = sides[index(side)];
+    int strength = 0;
+    for (const uint32_t i : st.alive) {
+        strength += st.hull[i] + st.shields[i];
+    }
+    return strength;
+}
+
+int CombatKernel::getStartTotal(CombatSide side) const {
+    const SideState& st = sides[index(side)];
+    int total = 0;
+    for (std::size_t i = 0; i < st.hull.size(); ++i) {
+        total += st.startHull[i] + st.startShields[i];
+    }
+    return total;
+}
+
+int CombatKernel::getDamageTaken(CombatSide side) const {
+    const SideState& st = sides[index(side)];
+    int taken = 0;
+    for (std::size_t i = 0; i < st.hull.size(); ++i) {
+        taken += (st.startHull[i] - st.hull[i]) + (st.startShields[i] - st.shields[i]);
+    }
+    return taken;
+}
+
+CombatKernel::Outcome CombatKernel::resolve(RandomStream& rng, int maxRounds) {
+    Outcome out;
+    while (out.rounds < maxRounds) {
+        resolveRound(rng);
+        out.rounds++;
+
+        if (aliveCount(CombatSide::ATTACKER) == 0) {
+            out.winner = CombatSide::DEFENDER;
+            return out;
+        } else if (aliveCount(CombatSide::DEFENDER) == 0) {
+            out.winner = CombatSide::ATTACKER;
+            return out;
+        }
+    }
+
+    out.byAttrition = true;
+    out.winner = getStrength(CombatSide::ATTACKER) > getStrength(CombatSide::DEFENDER)
+        ? CombatSide::ATTACKER : CombatSide::DEFENDER;
+    return out;
+}
+
+void CombatKernel::applySide(const SideState& st, Fleet& fleet) {
+    std::size_t i = 0;
+    for (const auto& ship : fleet.getShips()) {
+        if (!ship) continue;
+        if (i >= st.hull.size()) break;
+        // Hull only drops once shields are gone, so one takeDamage() call
+        // reproduces the final state exactly.
+        const int damage = (st.startShields[i] - st.shields[i]) + (st.startHull[i] - st.hull[i]);
+        if (damage > 0) ship->takeDamage(damage);
+        ++i;
+    }
+    fleet.removeDestroyed();
+}
+
+void CombatKernel::applyTo(Fleet& attacker, Fleet& defender) const {
+    applySide(sides[index(CombatSide::ATTACKER)], attacker);
+    applySide(sides[index(CombatSide::DEFENDER)], defender);
+}
@@ -0,0 +1,48 @@
+#include "diplomacy.h"
+
+void DiplomacyMatrix::reset(std::size_t empireCount) {
+    empires = empireCount;
+    wordsPerRow = (empireCount + 63) / 64;
+    bits.assign(PLANE_COUNT * empires * wordsPerRow, 0);
+}
+
+bool DiplomacyMatrix::test(Plane plane, EmpireId a, EmpireId b) const {
+    if (a >= empires || b >= empires) return false;
+    return (row(plane, a)[b / 64] >> (b % 64)) & 1u;
+}
+
+void DiplomacyMatrix::assign(Plane plane, EmpireId a, EmpireId b, bool value) {
+    if (a >= empires || b >= empires || a == b) return;
+    const uint64_t maskB = uint64_t{1} << (b % 64);
+    const uint64_t maskA = uint64_t{1} << (a % 64);
+    uint64_t& ab = row(plane, a)[b / 64];
+    uint64_t& ba = row(plane, b)[a / 64];
+    if (value) {
+        ab |= maskB;
+        ba |= maskA;
+    } else {
+        ab &= ~maskB;
+        ba &= ~maskA;
+    }
+}
+
+DiplomaticStance DiplomacyMatrix::getStance(EmpireId a, EmpireId b) const {
+    if (test(WAR, a, b)) return DiplomaticStance::WAR;
+    if (test(PEACE, a, b)) return DiplomaticStance::PEACE;
+    if (test(ALLIANCE, a, b)) return DiplomaticStance::ALLIANCE;
+    return DiplomaticStance::NEUTRAL;
+}
+
+void DiplomacyMatrix::setStance(EmpireId a, EmpireId b, DiplomaticStance stance) {
+    assign(WAR, a, b, stance == DiplomaticStance::WAR);
+    assign(PEACE, a, b, stance == DiplomaticStance::PEACE);
+    assign(ALLIANCE, a, b, stance == DiplomaticStance::ALLIANCE);
+}
+
+std::size_t DiplomacyMatrix::enemyCount(EmpireId a) const {
+    if (a >= empires) return 0;
+    const uint64_t* words = row(WAR, a);
+    std::size_t n = 0;
+    for (std::size_t w = 0; w < wordsPerRow; ++w) n += static_cast<std::size_t>(popcount(words[w]));
+    return n;
+}
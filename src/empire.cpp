@@ -1,19 +1,22 @@
 #include "empire.h"
 #include "galaxy.h"
+#include "combat.h"
+#include "profiler.h"
 #include <algorithm>
 
-Colony::Colony(const std::string& nm, std::shared_ptr<Planet> plt)
-    : name(nm), planet(plt), population(10), infrastructure(1), mines(0), factories(0) {}
+Colony::Colony(ColonyId cid, NameId nm, const Planet& plt)
+    : id(cid), owner(kNoEntity), name(nm), planet(plt.getId()), system(plt.getSystemId()), population(10), infrastructure(1), mines(0), factories(0) {}
 
 void Colony::grow() {
     double growthRate = 0.01 * infrastructure;
     population += static_cast<int>(population * growthRate);
 }
 
-Empire::Empire(const std::string& nm)
-    : name(nm), turn(0), totalPopulation(100), militaryStrength(0) {}
+Empire::Empire(const std::string& nm, EmpireId eid)
+    : id(eid), name(nm), turn(0), totalPopulation(100), militaryStrength(0) {}
 
 std::string Empire::advanceTurn() {
+    PROFILE_SCOPE("Empire::advanceTurn");
     turn++;
     
     // Produce resources
@@ -66,27 +69,24 @@ std::string Empire::advanceTurn() {
 }
 
 bool Empire::setResearch(const std::string& techId) {
-    auto tech = research.getTech(techId);
-    if (!tech || tech->isResearched()) {
+    // Only allow selecting unresearched technologies whose prerequisites are met.
+    if (!research.isAvailable(techId)) {
         return false;
     }
-
-    // Only allow selecting technologies that are currently available given prerequisites.
-    const auto available = research.getAvailableTechs();
-    for (const auto& availTech : available) {
-        if (availTech && availTech->getId() == techId) {
-            currentResearch = techId;
-            return true;
-        }
-    }
-
-    return false;
+    currentResearch = techId;
+    return true;
 }
 
 void Empire::addColony(std::shared_ptr<Colony> colony) {
+    colony->setOwner(id);
     colonies.push_back(colony);
 }
 
 void Empire::addFleet(std::shared_ptr<Fleet> fleet) {
     fleets.push_back(fleet);
+    fleetsByName.insert(fleet);
+}
+
+std::shared_ptr<Fleet> Empire::findFleetByName(const std::string& fleetName) const {
+    return fleetsByName.find(fleetName);
 }
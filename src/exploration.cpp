@@ -0,0 +1,39 @@
+#include "exploration.h"
+
+uint64_t ExplorationMap::lastWordMask() const {
+    const std::size_t used = systems % 64;
+    return used == 0 ? ~uint64_t{0} : (uint64_t{1} << used) - 1;
+}
+
+void ExplorationMap::reset(std::size_t empireCount, std::size_t systemCount) {
+    empires = empireCount;
+    systems = systemCount;
+    wordsPerRow = (systemCount + 63) / 64;
+    bits.assign(empires * wordsPerRow, 0);
+    explored.assign(empires, 0);
+}
+
+bool ExplorationMap::isExplored(EmpireId e, SystemId s) const {
+    if (e >= empires || s >= systems) return false;
+    return (row(e)[s / 64] >> (s % 64)) & 1u;
+}
+
+bool ExplorationMap::explore(EmpireId e, SystemId s) {
+    if (e >= empires || s >= systems) return false;
+    uint64_t& word = bits[e * wordsPerRow + s / 64];
+    const uint64_t mask = uint64_t{1} << (s % 64);
+    if (word & mask) return false;
+    word |= mask;
+    ++explored[e];
+    return true;
+}
+
+SystemIdView ExplorationMap::exploredSystems(EmpireId e) const {
+    if (e >= empires) return SystemIdView();
+    return SystemIdView(row(e), wordsPerRow, false, lastWordMask(), explored[e]);
+}
+
+SystemIdView ExplorationMap::unexploredSystems(EmpireId e) const {
+    if (e >= empires) return SystemIdView();
+    return SystemIdView(row(e), wordsPerRow, true, lastWordMask(), systems - explored[e]);
+}
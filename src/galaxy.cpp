@@ -1,158 +1,385 @@
 #include "galaxy.h"
 #include "empire.h"
+#include "rng.h"
+#include "thread_pool.h"
 #include <algorithm>
-#include <cctype>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iterator>
 #include <random>
 
-Star::Star(const std::string& nm, std::mt19937& gen, const std::string& type) : name(nm) {
-    static const std::vector<std::string> types = {
-        "Red Dwarf", "Yellow Dwarf", "Blue Giant", "Red Giant", "White Dwarf"
-    };
-    
-    if (type.empty()) {
-        std::uniform_int_distribution<std::size_t> dis(0, types.size() - 1);
-        starType = types[dis(gen)];
-    } else {
-        starType = type;
-    }
+namespace {
+const std::string kStarTypes[] = {
+    "Red Dwarf", "Yellow Dwarf", "Blue Giant", "Red Giant", "White Dwarf"
+};
+const std::string kPlanetTypes[] = {
+    "Terrestrial", "Gas Giant", "Ice", "Desert", "Ocean", "Volcanic"
+};
+const ResourceType kMineralTypes[] = {
+    ResourceType::DURANIUM, ResourceType::NEUTRONIUM, ResourceType::CORUNDIUM,
+    ResourceType::TRITANIUM, ResourceType::BORONIDE, ResourceType::MERCASSIUM,
+    ResourceType::VENDARITE, ResourceType::SORIUM, ResourceType::URIDIUM,
+    ResourceType::GALLICITE
+};
+const char* const kNamePrefixes[] = {
+    "Alpha", "Beta", "Gamma", "Delta", "Epsilon", "Zeta", "Eta",
+    "Theta", "Iota", "Kappa", "Lambda", "Mu", "Nu", "Xi", "Omicron"
+};
+const char* const kNameSuffixes[] = {
+    "Centauri", "Draconis", "Eridani", "Cygni", "Leonis", "Aquarii",
+    "Cassiopeiae", "Orionis", "Pegasi", "Andromedae"
+};
+constexpr std::size_t kNameCombinations = std::size(kNamePrefixes) * std::size(kNameSuffixes);
+
+// Streams are keyed by (seed ^ kGalaxyKeyTag, system, planet); planet 0 is the
+// system itself. Galaxy seeds are 32-bit, so the tag keeps these keys apart
+// from RngService's, which Game derives from the same seed.
+constexpr uint64_t kGalaxyKeyTag = 0x47414C4158590000ULL; // "GALAXY"
+constexpr std::size_t kSystemsPerChunk = 1024;
+
+// Draws for SEQUENTIAL_MT19937 through the std distributions it always used,
+// so old seeds keep rebuilding the same galaxy on this standard library.
+class SequentialDraws {
+private:
+    std::mt19937& gen;
+
+public:
+    explicit SequentialDraws(std::mt19937& gen) : gen(gen) {}
+
+    std::size_t below(std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(gen); }
+    int range(int lo, int hi) { return std::uniform_int_distribution<>(lo, hi)(gen); }
+    double uniform01() { return std::uniform_real_distribution<>(0.0, 1.0)(gen); }
+};
+
+// Everything about a system except its planets, in draw order. The name is
+// kept as (prefix, suffix) until the serial pass numbers repeated names and
+// interns the result.
+struct SystemDraw {
+    uint8_t prefix = 0;
+    uint8_t suffix = 0;
+    uint8_t starType = 0;
+    uint8_t planetCount = 0;
+    uint32_t nameUse = 1;
+    NameId name = kNoName;
+    int x = 0, y = 0, z = 0;
+};
+
+template <typename Draws>
+void drawName(Draws& draws, SystemDraw& d) {
+    d.prefix = static_cast<uint8_t>(draws.below(std::size(kNamePrefixes)));
+    d.suffix = static_cast<uint8_t>(draws.below(std::size(kNameSuffixes)));
 }
 
-Planet::Planet(const std::string& nm, std::mt19937& gen, const std::string& type)
-    : name(nm), colonized(false) {
-    static const std::vector<std::string> types = {
-        "Terrestrial", "Gas Giant", "Ice", "Desert", "Ocean", "Volcanic"
-    };
-    
-    if (type.empty()) {
-        std::uniform_int_distribution<std::size_t> dis(0, types.size() - 1);
-        planetType = types[dis(gen)];
-    } else {
-        planetType = type;
+// The old generator built the name as prefix + " " + suffix with both draws
+// inside the expression; GCC evaluates those right to left.
+void drawName(SequentialDraws& draws, SystemDraw& d) {
+    d.suffix = static_cast<uint8_t>(draws.below(std::size(kNameSuffixes)));
+    d.prefix = static_cast<uint8_t>(draws.below(std::size(kNamePrefixes)));
+}
+
+// The home system's name and position are fixed; only its star and planet
+// count are drawn.
+template <typename Draws>
+SystemDraw drawSystem(Draws& draws, int extent, bool home) {
+    SystemDraw d;
+    if (!home) {
+        drawName(draws, d);
+        d.x = draws.range(-extent, extent);
+        d.y = draws.range(-extent, extent);
+        d.z = draws.range(-20, 20);
     }
-    
-    generateMinerals(gen);
-}
-
-void Planet::generateMinerals(std::mt19937& gen) {
-    std::uniform_real_distribution<> chance(0.0, 1.0);
-    std::uniform_int_distribution<> amount(1000, 100000);
-    
-    std::vector<ResourceType> mineralTypes = {
-        ResourceType::DURANIUM, ResourceType::NEUTRONIUM, ResourceType::CORUNDIUM,
-        ResourceType::TRITANIUM, ResourceType::BORONIDE, ResourceType::MERCASSIUM,
-        ResourceType::VENDARITE, ResourceType::SORIUM, ResourceType::URIDIUM,
-        ResourceType::GALLICITE
-    };
-    
-    for (const auto& mineral : mineralTypes) {
-        if (chance(gen) > 0.3) {  // 70% chance to have each mineral
-            minerals[mineral] = amount(gen);
+    d.starType = static_cast<uint8_t>(draws.below(std::size(kStarTypes)));
+    d.planetCount = static_cast<uint8_t>(draws.range(2, 10));
+    return d;
+}
+
+// The type is a planet's first draw, so it can be checked without the rest.
+template <typename Draws>
+std::size_t drawPlanetType(Draws& draws) {
+    return draws.below(std::size(kPlanetTypes));
+}
+
+// Terrestrial or Ocean.
+bool isHabitableType(std::size_t type) {
+    return type == 0 || type == 4;
+}
+
+template <typename Draws>
+Planet drawPlanet(Draws& draws, PlanetId id, SystemId system, NameId systemName, int orbit) {
+    const int type = static_cast<int>(drawPlanetType(draws));
+    ResourceAmounts minerals;
+    for (const ResourceType mineral : kMineralTypes) {
+        if (draws.uniform01() > 0.3) {  // 70% chance to have each mineral
+            minerals[mineral] = draws.range(1000, 100000);
         }
     }
+    return Planet(id, system, systemName, orbit, type, minerals);
+}
+
+std::string systemName(const SystemDraw& d, bool home) {
+    if (home) return "Sol";
+    std::string name = std::string(kNamePrefixes[d.prefix]) + " " + kNameSuffixes[d.suffix];
+    // Names are looked up (and saved) by string, so repeats get a numeric suffix.
+    if (d.nameUse > 1) name += " " + std::to_string(d.nameUse);
+    return name;
+}
+
+// Appends the system's planets to the arena as one block.
+template <typename PlanetDraws>
+void buildPlanets(std::vector<Planet>& arena, NameId systemName, SystemId system, PlanetId firstPlanet,
+                  int count, PlanetDraws&& planetDraws) {
+    for (int i = 0; i < count; ++i) {
+        arena.push_back(drawPlanet(planetDraws(i), firstPlanet + static_cast<PlanetId>(i), system, systemName, i));
+    }
 }
 
-void Planet::colonize(std::shared_ptr<Colony> col) {
-    colonized = true;
-    colony = col;
+RandomStream systemStream(uint32_t seed, SystemId system) {
+    return RandomStream(rngDeriveKey(seed ^ kGalaxyKeyTag, system));
 }
 
-StarSystem::StarSystem(const std::string& nm, std::mt19937& gen, int posX, int posY, int posZ)
-    : name(nm), x(posX), y(posY), z(posZ), star(nm + " Primary", gen), explored(false) {
-    generatePlanets(gen);
+RandomStream planetStream(uint32_t seed, SystemId system, int planet) {
+    return RandomStream(rngDeriveKey(seed ^ kGalaxyKeyTag, system, static_cast<uint64_t>(planet) + 1));
 }
 
-void StarSystem::generatePlanets(std::mt19937& gen) {
-    std::uniform_int_distribution<> numPlanets(2, 10);
-    
-    int count = numPlanets(gen);
-    for (int i = 0; i < count; ++i) {
-        std::string planetName = name + " " + char('A' + i);
-        planets.push_back(std::make_shared<Planet>(planetName, gen));
+// The disk widens with the system count so star density stays that of the
+// classic 20-system, 101x101 galaxy.
+int diskExtent(int numSystems) {
+    return std::max(50, static_cast<int>(std::lround(50.0 * std::sqrt(numSystems / 20.0))));
+}
+} // namespace
+
+std::string Star::getName() const {
+    return nameOf(systemName) + " Primary";
+}
+
+const std::string& Star::getStarType() const {
+    return kStarTypes[starType];
+}
+
+Planet::Planet(PlanetId pid, SystemId sys, NameId sysName, int orb, int type, const ResourceAmounts& mins)
+    : minerals(mins), id(pid), system(sys), systemName(sysName), colony(kNoEntity),
+      orbit(static_cast<uint8_t>(orb)), planetType(static_cast<uint8_t>(type)) {}
+
+std::string Planet::getName() const {
+    const std::string& sys = nameOf(systemName);
+    std::string name;
+    name.reserve(sys.size() + 2);
+    name.append(sys).append(1, ' ').append(1, getOrbitLetter());
+    return name;
+}
+
+const std::string& Planet::getPlanetType() const {
+    return kPlanetTypes[planetType];
+}
+
+bool Planet::isHabitable() const {
+    return isHabitableType(planetType);
+}
+
+StarSystem::StarSystem(SystemId sid, NameId nm, uint8_t star, Galaxy* owner,
+                       PlanetId first, int count, int posX, int posY, int posZ)
+    : id(sid), name(nm), x(posX), y(posY), z(posZ), galaxy(owner), firstPlanet(first), planetSlot(kNoSlot),
+      planetCount(static_cast<uint8_t>(count)), starType(star) {}
+
+Span<Planet> StarSystem::getPlanets() {
+    return Span<Planet>(galaxy->planetsOf(*this), planetCount);
+}
+
+Span<const Planet> StarSystem::getPlanets() const {
+    return Span<const Planet>(galaxy->planetsOf(*this), planetCount);
+}
+
+bool StarSystem::hasColonizablePlanet() const {
+    if (!hasPlanetDetails()) return galaxy->hasColonizableType(*this);
+    for (const Planet& planet : getPlanets()) {
+        if (planet.isHabitable() && !planet.isColonized()) return true;
     }
+    return false;
 }
 
-std::vector<std::shared_ptr<Planet>> StarSystem::getColonizablePlanets() const {
-    std::vector<std::shared_ptr<Planet>> colonizable;
-    for (const auto& planet : planets) {
-        if ((planet->getPlanetType() == "Terrestrial" || planet->getPlanetType() == "Ocean") 
-            && !planet->isColonized()) {
-            colonizable.push_back(planet);
+std::vector<Planet*> StarSystem::getColonizablePlanets() {
+    std::vector<Planet*> colonizable;
+    for (Planet& planet : getPlanets()) {
+        if (planet.isHabitable() && !planet.isColonized()) {
+            colonizable.push_back(&planet);
         }
     }
     return colonizable;
 }
 
-Galaxy::Galaxy(int numSystems, uint32_t seed)
-    : seed(seed ? seed : std::random_device{}()), gen(this->seed) {
-    generateGalaxy(numSystems);
-}
-
-void Galaxy::generateGalaxy(int numSystems) {
-    // Create home system
-    homeSystem = std::make_shared<StarSystem>("Sol", gen, 0, 0, 0);
-    homeSystem->explore();
-    systems.push_back(homeSystem);
-    
-    // Generate other systems
-    std::uniform_int_distribution<> xDist(-50, 50);
-    std::uniform_int_distribution<> yDist(-50, 50);
-    std::uniform_int_distribution<> zDist(-20, 20);
-    
-    for (int i = 0; i < numSystems - 1; ++i) {
-        std::string name = generateStarName(i);
-        int x = xDist(gen);
-        int y = yDist(gen);
-        int z = zDist(gen);
-        systems.push_back(std::make_shared<StarSystem>(name, gen, x, y, z));
+Galaxy::Galaxy(int numSystems, uint32_t seed, ThreadPool* workers, GalaxyGenerator generator)
+    : seed(seed ? seed : std::random_device{}()), generator(generator) {
+    numSystems = std::max(numSystems, 1);
+    if (generator == GalaxyGenerator::SEQUENTIAL_MT19937) {
+        generateSequential(numSystems);
+    } else {
+        generateFromStreams(numSystems, workers);
     }
+    finishGeneration();
 }
 
-std::string Galaxy::generateStarName(int index) {
-    (void)index;
-    static const std::vector<std::string> prefixes = {
-        "Alpha", "Beta", "Gamma", "Delta", "Epsilon", "Zeta", "Eta",
-        "Theta", "Iota", "Kappa", "Lambda", "Mu", "Nu", "Xi", "Omicron"
-    };
-    static const std::vector<std::string> suffixes = {
-        "Centauri", "Draconis", "Eridani", "Cygni", "Leonis", "Aquarii",
-        "Cassiopeiae", "Orionis", "Pegasi", "Andromedae"
-    };
-    
-    std::uniform_int_distribution<std::size_t> prefixDist(0, prefixes.size() - 1);
-    std::uniform_int_distribution<std::size_t> suffixDist(0, suffixes.size() - 1);
-    
-    return prefixes[prefixDist(gen)] + " " + suffixes[suffixDist(gen)];
-}
-
-std::shared_ptr<StarSystem> Galaxy::findSystemByName(const std::string& name) const {
-    auto toLowerChar = [](unsigned char c) { return static_cast<char>(std::tolower(c)); };
-    std::string want = name;
-    std::transform(want.begin(), want.end(), want.begin(), toLowerChar);
-    for (const auto& sys : systems) {
-        if (!sys) continue;
-        std::string cur = sys->getName();
-        std::transform(cur.begin(), cur.end(), cur.begin(), toLowerChar);
-        if (cur == want) return sys;
+void Galaxy::generateSequential(int numSystems) {
+    std::mt19937 gen(seed);
+    SequentialDraws draws(gen);
+    const int extent = diskExtent(numSystems);
+    std::array<uint32_t, kNameCombinations> nameUses{};
+
+    systems.reserve(static_cast<std::size_t>(numSystems));
+    planetOffsets.reserve(static_cast<std::size_t>(numSystems) + 1);
+    planetOffsets.push_back(0);
+    for (int i = 0; i < numSystems; ++i) {
+        const SystemId id = static_cast<SystemId>(i);
+        SystemDraw d = drawSystem(draws, extent, id == 0);
+        if (id != 0) d.nameUse = ++nameUses[d.prefix * std::size(kNameSuffixes) + d.suffix];
+        const PlanetId first = planetOffsets.back();
+        systems.emplace_back(id, internName(systemName(d, id == 0)), d.starType, this,
+                             first, d.planetCount, d.x, d.y, d.z);
+        // The planets' draws follow the system's in the one sequence, so they
+        // are made now and never evicted; arena slots equal planet ids.
+        systems.back().planetSlot = first;
+        buildPlanets(planets, systems.back().name, id, first, d.planetCount,
+                     [&](int) -> SequentialDraws& { return draws; });
+        planetOffsets.push_back(first + d.planetCount);
     }
-    return nullptr;
 }
 
-std::vector<std::shared_ptr<StarSystem>> Galaxy::getExploredSystems() const {
-    std::vector<std::shared_ptr<StarSystem>> explored;
-    for (const auto& sys : systems) {
-        if (sys->isExplored()) {
-            explored.push_back(sys);
+void Galaxy::generateFromStreams(int numSystems, ThreadPool* workers) {
+    const std::size_t count = static_cast<std::size_t>(numSystems);
+    const auto forChunks = [workers, count](const std::function<void(std::size_t, std::size_t)>& fn) {
+        if (workers) {
+            workers->parallelFor(count, fn, kSystemsPerChunk);
+        } else {
+            fn(0, count);
         }
+    };
+
+    // Pass 1 draws names, positions and planet counts: one stream per system.
+    const int extent = diskExtent(numSystems);
+    std::vector<SystemDraw> draws(count);
+    forChunks([&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            RandomStream stream = systemStream(seed, static_cast<SystemId>(i));
+            draws[i] = drawSystem(stream, extent, i == 0);
+        }
+    });
+
+    // Repeated names are numbered and interned, and planet ids assigned, in
+    // system order.
+    std::array<uint32_t, kNameCombinations> nameUses{};
+    planetOffsets.resize(count + 1);
+    planetOffsets[0] = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i != 0) draws[i].nameUse = ++nameUses[draws[i].prefix * std::size(kNameSuffixes) + draws[i].suffix];
+        draws[i].name = internName(systemName(draws[i], i == 0));
+        planetOffsets[i + 1] = planetOffsets[i] + draws[i].planetCount;
     }
-    return explored;
+
+    // The system records are small and written in order; planets draw from
+    // their own streams when first needed; see loadPlanets().
+    systems.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const SystemDraw& d = draws[i];
+        systems.emplace_back(static_cast<SystemId>(i), d.name, d.starType, this, planetOffsets[i],
+                             d.planetCount, d.x, d.y, d.z);
+    }
+}
+
+void Galaxy::loadPlanets(const StarSystem& sys) const {
+    if (generator != GalaxyGenerator::COUNTER_STREAMS) return;
+    sys.planetSlot = static_cast<uint32_t>(planets.size());
+    RandomStream stream;
+    buildPlanets(planets, sys.name, sys.id, sys.firstPlanet, sys.planetCount, [&](int planet) -> RandomStream& {
+        stream = planetStream(seed, sys.id, planet);
+        return stream;
+    });
+    detailed.push_back(sys.id);
+}
+
+Planet* Galaxy::planetsOf(const StarSystem& sys) const {
+    if (sys.planetSlot == StarSystem::kNoSlot) loadPlanets(sys);
+    return planets.data() + sys.planetSlot;
 }
 
-std::vector<std::shared_ptr<StarSystem>> Galaxy::getUnexploredSystems() const {
-    std::vector<std::shared_ptr<StarSystem>> unexplored;
-    for (const auto& sys : systems) {
-        if (!sys->isExplored()) {
-            unexplored.push_back(sys);
+bool Galaxy::hasColonizableType(const StarSystem& sys) const {
+    for (int i = 0; i < sys.planetCount; ++i) {
+        RandomStream stream = planetStream(seed, sys.id, i);
+        if (isHabitableType(drawPlanetType(stream))) return true;
+    }
+    return false;
+}
+
+std::size_t Galaxy::evictUntouchedDetails() {
+    // Blocks sit in `detailed` order, so kept blocks only ever move down.
+    std::size_t evicted = 0;
+    std::size_t kept = 0;
+    std::size_t nextSlot = 0;
+    for (const SystemId id : detailed) {
+        StarSystem& sys = systems[id];
+        const auto first = planets.begin() + sys.planetSlot;
+        const auto last = first + sys.planetCount;
+        if (std::none_of(first, last, [](const Planet& planet) { return planet.isColonized(); })) {
+            sys.planetSlot = StarSystem::kNoSlot;
+            ++evicted;
+            continue;
         }
+        if (sys.planetSlot != nextSlot) std::move(first, last, planets.begin() + nextSlot);
+        sys.planetSlot = static_cast<uint32_t>(nextSlot);
+        nextSlot += sys.planetCount;
+        detailed[kept++] = id;
     }
-    return unexplored;
+    if (evicted == 0) return 0;
+    planets.erase(planets.begin() + nextSlot, planets.end());
+    detailed.resize(kept);
+    return evicted;
+}
+
+std::size_t Galaxy::getDetailedSystemCount() const {
+    return generator == GalaxyGenerator::COUNTER_STREAMS ? detailed.size() : systems.size();
+}
+
+void Galaxy::finishGeneration() {
+    buildSpatialIndex();
+
+    systemsByName.reserve(systems.size());
+    for (StarSystem& sys : systems) {
+        systemsByName.insert(&sys);
+    }
+}
+
+void Galaxy::buildSpatialIndex() {
+    std::vector<SpatialPoint> points;
+    points.reserve(systems.size());
+    for (const StarSystem& sys : systems) {
+        points.push_back(SpatialPoint{sys.getX(), sys.getY(), sys.getZ()});
+    }
+    spatialIndex.build(points);
+}
+
+Planet* Galaxy::getPlanet(PlanetId id) {
+    return const_cast<Planet*>(static_cast<const Galaxy&>(*this).getPlanet(id));
+}
+
+const Planet* Galaxy::getPlanet(PlanetId id) const {
+    if (id >= getPlanetCount()) return nullptr;
+    // First system whose range ends past `id`.
+    const auto it = std::upper_bound(planetOffsets.begin(), planetOffsets.end(), id);
+    const std::size_t sys = static_cast<std::size_t>(it - planetOffsets.begin()) - 1;
+    return planetsOf(systems[sys]) + (id - planetOffsets[sys]);
+}
+
+std::vector<SystemId> Galaxy::idsOf(const std::vector<std::size_t>& indices) {
+    return std::vector<SystemId>(indices.begin(), indices.end());
+}
+
+std::vector<SystemId> Galaxy::findSystemsWithin(int x, int y, int z, double radius) const {
+    return idsOf(spatialIndex.withinRadius(x, y, z, radius));
+}
+
+std::vector<SystemId> Galaxy::findNearestSystems(int x, int y, int z, std::size_t k) const {
+    return idsOf(spatialIndex.nearest(x, y, z, k));
+}
+
+std::vector<SystemId> Galaxy::findSystemsInBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ) const {
+    return idsOf(spatialIndex.inBox(minX, minY, minZ, maxX, maxY, maxZ));
 }
@@ -1,10 +1,8 @@
 #include "game.h"
 #include "battle_viewer.h"
+#include "profiler.h"
 #include <algorithm>
 #include <cctype>
-#include <fstream>
-#include <map>
-#include <random>
 #include <sstream>
 
 namespace {
@@ -103,17 +101,16 @@ static bool fleetHasOperationalShips(const std::shared_ptr<Fleet>& fleet) {
     return false;
 }
 
-static std::shared_ptr<Fleet> pickRandomOperationalFleet(const std::vector<std::shared_ptr<Fleet>>& fleets, std::mt19937& gen) {
+static std::shared_ptr<Fleet> pickRandomOperationalFleet(const std::vector<std::shared_ptr<Fleet>>& fleets, RandomStream& rng) {
     std::vector<std::shared_ptr<Fleet>> candidates;
     for (const auto& f : fleets) {
         if (fleetHasOperationalShips(f)) candidates.push_back(f);
     }
     if (candidates.empty()) return nullptr;
-    std::uniform_int_distribution<std::size_t> dis(0, candidates.size() - 1);
-    return candidates[dis(gen)];
+    return candidates[rng.below(candidates.size())];
 }
 
-static ShipClass aiPickBuildClass(int turn, std::mt19937& gen) {
+static ShipClass aiPickBuildClass(int turn, RandomStream& rng) {
     // Slowly ramps up ship sizes over time.
     std::vector<ShipClass> options;
     options.push_back(ShipClass::FIGHTER);
@@ -125,88 +122,122 @@ static ShipClass aiPickBuildClass(int turn, std::mt19937& gen) {
     if (turn >= 14) options.push_back(ShipClass::BATTLESHIP);
     if (turn >= 16) options.push_back(ShipClass::CARRIER);
 
-    std::uniform_int_distribution<std::size_t> dis(0, options.size() - 1);
-    return options[dis(gen)];
+    return options[rng.below(options.size())];
 }
 
-static std::string trim(std::string s) {
-    auto isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
-    while (!s.empty() && isSpace((unsigned char)s.front())) s.erase(s.begin());
-    while (!s.empty() && isSpace((unsigned char)s.back())) s.pop_back();
-    return s;
+// "Zorg Collective", "Krell Dominion", then the remaining species/title pairs;
+// 21 and 10 are coprime, so the first 200 names are distinct.
+static std::string aiEmpireName(int index) {
+    static const char* const species[] = {
+        "Zorg", "Krell", "Vashti", "Orun", "Tessari", "Quill", "Morvath", "Sybek", "Ythri", "Draal",
+        "Keth", "Nuvari", "Osk", "Phaedri", "Rakhar", "Sulenn", "Tavoc", "Uxmal", "Varrin", "Xochar"};
+    static const char* const titles[] = {
+        "Collective", "Dominion", "Hegemony", "Imperium", "Union", "Concord", "Directorate", "Swarm",
+        "Ascendancy", "Compact"};
+    constexpr int kSpecies = 20;
+    constexpr int kTitles = 10;
+    const int s = index % kSpecies;
+    const int t = (index / kSpecies + index) % kTitles;
+    std::string name = std::string(species[s]) + " " + titles[t];
+    const int round = index / (kSpecies * kTitles);
+    if (round > 0) name += " " + std::to_string(round + 1);
+    return name;
 }
 
-static bool parseInt(const std::string& s, int& out) {
-    try {
-        size_t idx = 0;
-        const int v = std::stoi(s, &idx);
-        if (idx != s.size()) return false;
-        out = v;
-        return true;
-    } catch (...) {
-        return false;
-    }
+// The AI aims for the cheapest unresearched tech of the earliest era it has
+// not finished and researches along that plan, so it works through the tree
+// era by era. Goals are derived from the researched set alone, so nothing
+// extra needs saving.
+static std::optional<Technology> aiPickResearch(const ResearchTree& research) {
+    const TechCatalogue& catalogue = research.getCatalogue();
+    bool any = false;
+    TechEra goalEra = TechEra::PRE_WARP;
+    for (std::size_t i = 0; i < catalogue.size(); ++i) {
+        const TechIndex index = static_cast<TechIndex>(i);
+        if (research.isResearched(index)) continue;
+        goalEra = any ? std::min(goalEra, catalogue.get(index).era) : catalogue.get(index).era;
+        any = true;
+    }
+    if (!any) return std::nullopt;
+
+    const ResearchPlan* best = nullptr;
+    for (std::size_t i = 0; i < catalogue.size(); ++i) {
+        const TechIndex index = static_cast<TechIndex>(i);
+        if (research.isResearched(index) || catalogue.get(index).era != goalEra) continue;
+        const ResearchPlan* plan = research.planPathTo(index);
+        if (plan && !plan->steps.empty() && (!best || plan->totalCost < best->totalCost)) best = plan;
+    }
+    if (!best) return std::nullopt;
+    return Technology(research, best->steps.front());
 }
 
-static std::vector<std::string> split(const std::string& s, char delim) {
-    std::vector<std::string> parts;
-    std::string cur;
-    for (char c : s) {
-        if (c == delim) {
-            parts.push_back(cur);
-            cur.clear();
-        } else {
-            cur.push_back(c);
+// Outcome of one AI's decide/produce phase, consumed by the serial resolve
+// phase of Game::advanceTurn().
+struct AiTurnState {
+    RandomStream rng;
+    std::string turnReport;
+    bool startedResearch = false;
+    std::string startedResearchName;
+    bool wantsColony = false;
+    int builtShips = 0;
+    ShipClass builtClass = ShipClass::FIGHTER;
+    // Ids are handed out in the serial resolve phase so they match the serial run.
+    std::shared_ptr<Ship> builtShip;
+};
+
+// Below this many AIs the pool costs more than it saves.
+constexpr std::size_t kAiSerialThreshold = 4;
+
+// Research, the colonization roll and shipbuilding: only `ai` and `st` change.
+static void aiDecideTurn(Empire& ai, AiTurnState& st, bool narrate) {
+    PROFILE_SCOPE("AI turn");
+    RandomStream& aiRng = st.rng;
+
+    st.turnReport = ai.advanceTurn();
+    if (!narrate) st.turnReport.clear();
+
+    // If not researching anything, take the next step towards the AI's goal.
+    if (ai.getCurrentResearch().empty()) {
+        PROFILE_SCOPE("AI research selection");
+        auto next = aiPickResearch(ai.getResearch());
+        if (next && ai.setResearch(next->getId())) {
+            st.startedResearch = true;
+            if (narrate) st.startedResearchName = next->getName();
         }
     }
-    parts.push_back(cur);
-    return parts;
-}
 
-static std::string findSystemForPlanet(const Galaxy& g, const std::shared_ptr<Planet>& planet) {
-    if (!planet) return {};
-    for (const auto& sys : g.getSystems()) {
-        if (!sys) continue;
-        for (const auto& p : sys->getPlanets()) {
-            if (p == planet) return sys->getName();
+    st.wantsColony = aiRng.chance(0.25);
+
+    // AI shipbuilding (simple): sometimes add a ship to its first fleet.
+    auto& aiFleets = ai.getFleets();
+    if (!aiFleets.empty() && aiFleets[0]) {
+        if (aiRng.chance(0.45)) {
+            PROFILE_SCOPE("AI shipbuilding");
+            st.builtClass = aiPickBuildClass(ai.getTurn(), aiRng);
+            const int shipIndex = static_cast<int>(aiFleets[0]->getShips().size() + 1);
+            st.builtShip = makeShipForClass(ai, ai.getName(), st.builtClass, shipIndex);
+            aiFleets[0]->addShip(st.builtShip);
+            st.builtShips++;
         }
     }
-    return {};
 }
 
-static std::shared_ptr<Planet> findPlanetInSystem(const std::shared_ptr<StarSystem>& sys, const std::string& planetName) {
+// Planet names are "<system> <orbit letter>", so only the letter picks the planet.
+static Planet* findPlanetInSystem(StarSystem* sys, NameId planetName) {
     if (!sys) return nullptr;
-    for (const auto& p : sys->getPlanets()) {
-        if (p && p->getName() == planetName) return p;
-    }
-    return nullptr;
-}
-
-static std::string serializeResources(const ResourceStorage& r) {
-    // Comma-separated key:value pairs.
-    std::ostringstream oss;
-    bool first = true;
-    for (const auto& kv : r.snapshot()) {
-        if (!first) oss << ",";
-        first = false;
-        oss << resourceTypeToString(kv.first) << ":" << kv.second;
+    const std::string& name = nameOf(planetName);
+    const std::string& sysName = sys->getName();
+    if (name.size() != sysName.size() + 2 || name.compare(0, sysName.size(), sysName) != 0 ||
+        name[sysName.size()] != ' ') {
+        return nullptr;
     }
-    return oss.str();
-}
-
-static void applyResourcesForLoad(ResourceStorage& r, const std::string& encoded) {
-    for (const auto& item : split(encoded, ',')) {
-        const auto kv = split(trim(item), ':');
-        if (kv.size() != 2) continue;
-        ResourceType t;
-        int amount = 0;
-        if (!resourceTypeFromString(trim(kv[0]), t)) continue;
-        if (!parseInt(trim(kv[1]), amount)) continue;
-        r.set(t, amount);
+    for (Planet& p : sys->getPlanets()) {
+        if (p.getOrbitLetter() == name.back()) return &p;
     }
+    return nullptr;
 }
 
-static std::shared_ptr<Ship> makeNamedShipForClass(const Empire& e, const std::string& shipName, ShipClass shipClass) {
+static std::shared_ptr<Ship> makeNamedShipForClass(const Empire& e, NameId shipName, ShipClass shipClass) {
     Weapon beam = makeBestBeam(e);
     Weapon missile = makeBestMissile(e);
     Weapon railgun = makeRailgun();
@@ -238,313 +269,166 @@ static std::shared_ptr<Ship> makeNamedShipForClass(const Empire& e, const std::s
             return shipWith(50, 20, std::vector<Weapon>{beam});
     }
 }
-} // namespace
-
-Game::Game(const std::string& empireName, uint32_t galaxySeed)
-    : empire(std::make_shared<Empire>(empireName)),
-      galaxy(std::make_shared<Galaxy>(20, galaxySeed)),
-      running(false) {
-    setupGame();
-}
 
-std::string Game::quickSave(const std::string& path) const {
-    if (!empire || !galaxy) return "Cannot save: game not initialized";
-
-    std::ofstream out(path, std::ios::out | std::ios::trunc);
-    if (!out.is_open()) {
-        return "Cannot save: failed to open file: " + path;
+static void captureEmpire(const Galaxy& galaxy, const Empire& e, SavedEmpire& out) {
+    out.name = e.getName();
+    out.turn = e.getTurn();
+    out.currentResearch = e.getCurrentResearch();
+    const ResourceAmounts& stock = e.getResources().snapshot();
+    out.resources.reserve(kResourceTypeCount);
+    for (std::size_t i = 0; i < kResourceTypeCount; ++i) {
+        out.resources.emplace_back(static_cast<ResourceType>(i), stock[i]);
     }
 
-    out << "AURORA_SAVE_V1\n";
-    out << "seed=" << galaxy->getSeed() << "\n";
-    out << "numSystems=" << galaxy->getSystems().size() << "\n";
-
-    out << "[Player]\n";
-    out << "name=" << empire->getName() << "\n";
-    out << "turn=" << empire->getTurn() << "\n";
-    out << "currentResearch=" << empire->getCurrentResearch() << "\n";
-    out << "resources=" << serializeResources(empire->getResources()) << "\n";
-
-    for (const auto& tech : empire->getResearch().getAllTechs()) {
-        if (!tech) continue;
-        if (tech->isResearched() || tech->getProgress() > 0) {
-            out << "tech=" << tech->getId() << "," << tech->getProgress() << "," << (tech->isResearched() ? 1 : 0) << "\n";
+    for (const auto& tech : e.getResearch().getAllTechs()) {
+        if (tech.isResearched() || tech.getProgress() > 0) {
+            out.techs.push_back(SavedTech{tech.getId(), tech.getProgress(), tech.isResearched()});
         }
     }
 
-    out << "[Explored]\n";
-    for (const auto& sys : galaxy->getExploredSystems()) {
-        if (!sys) continue;
-        out << "system=" << sys->getName() << "\n";
+    for (const auto& c : e.getColonies()) {
+        if (!c) continue;
+        SavedColony sc;
+        sc.name = c->getNameId();
+        if (auto sys = galaxy.getSystem(c->getSystemId())) sc.system = sys->getNameId();
+        if (auto planet = galaxy.getPlanet(c->getPlanetId())) sc.planet = internName(planet->getName());
+        sc.pop = c->getPopulation();
+        sc.mines = c->getMines();
+        sc.factories = c->getFactories();
+        out.colonies.push_back(std::move(sc));
     }
 
-    out << "[Colonies]\n";
-    for (const auto& c : empire->getColonies()) {
-        if (!c) continue;
-        const std::string sysName = findSystemForPlanet(*galaxy, c->getPlanet());
-        const std::string planetName = c->getPlanet() ? c->getPlanet()->getName() : "";
-        out << "colony=" << c->getName()
-            << ";system=" << sysName
-            << ";planet=" << planetName
-            << ";pop=" << c->getPopulation()
-            << ";mines=" << c->getMines()
-            << ";factories=" << c->getFactories() << "\n";
-    }
-
-    out << "[Fleets]\n";
-    for (const auto& f : empire->getFleets()) {
+    for (const auto& f : e.getFleets()) {
         if (!f) continue;
-        const std::string sysName = f->getLocation() ? f->getLocation()->getName() : "";
-        out << "fleet=" << f->getName() << ";system=" << sysName << "\n";
+        SavedFleet sf;
+        sf.name = f->getNameId();
+        if (auto sys = galaxy.getSystem(f->getLocation())) sf.system = sys->getNameId();
         for (const auto& ship : f->getShips()) {
             if (!ship) continue;
-            out << "ship=" << ship->getName()
-                << ";class=" << shipClassToString(ship->getShipClass())
-                << ";hull=" << ship->getHull()
-                << ";shields=" << ship->getShields() << "\n";
+            sf.ships.push_back(SavedShip{ship->getNameId(), ship->getShipClass(), ship->getHull(), ship->getShields()});
         }
-        out << "endfleet\n";
+        out.fleets.push_back(std::move(sf));
     }
+}
+} // namespace
 
-    out << "[Hostiles]\n";
-    for (const auto& h : hostileEmpires) {
-        if (!h) continue;
-        out << "[Hostile]\n";
-        out << "name=" << h->getName() << "\n";
-        out << "contacted=" << (isHostileContacted(h->getName()) ? 1 : 0) << "\n";
-        out << "atWar=" << (isHostileAtWar(h->getName()) ? 1 : 0) << "\n";
-        out << "turn=" << h->getTurn() << "\n";
-        out << "currentResearch=" << h->getCurrentResearch() << "\n";
-        out << "resources=" << serializeResources(h->getResources()) << "\n";
-        for (const auto& tech : h->getResearch().getAllTechs()) {
-            if (!tech) continue;
-            if (tech->isResearched() || tech->getProgress() > 0) {
-                out << "tech=" << tech->getId() << "," << tech->getProgress() << "," << (tech->isResearched() ? 1 : 0) << "\n";
-            }
-        }
-        for (const auto& c : h->getColonies()) {
-            if (!c) continue;
-            const std::string sysName = findSystemForPlanet(*galaxy, c->getPlanet());
-            const std::string planetName = c->getPlanet() ? c->getPlanet()->getName() : "";
-            out << "colony=" << c->getName()
-                << ";system=" << sysName
-                << ";planet=" << planetName
-                << ";pop=" << c->getPopulation()
-                << ";mines=" << c->getMines()
-                << ";factories=" << c->getFactories() << "\n";
-        }
-        for (const auto& f : h->getFleets()) {
-            if (!f) continue;
-            const std::string sysName = f->getLocation() ? f->getLocation()->getName() : "";
-            out << "fleet=" << f->getName() << ";system=" << sysName << "\n";
-            for (const auto& ship : f->getShips()) {
-                if (!ship) continue;
-                out << "ship=" << ship->getName()
-                    << ";class=" << shipClassToString(ship->getShipClass())
-                    << ";hull=" << ship->getHull()
-                    << ";shields=" << ship->getShields() << "\n";
-            }
-            out << "endfleet\n";
-        }
-        out << "endhostile\n";
-    }
+Game::Game(const std::string& empireName, uint32_t galaxySeed, const GameSetup& setup)
+    : empire(std::make_shared<Empire>(empireName)),
+      autosaveInterval(0),
+      autosaveFormat(SaveFormat::BINARY_V2),
+      running(false),
+      narrative(true),
+      parallelAi(true) {
+    const int systems = std::max(1, setup.galaxySystems);
+    galaxy = std::make_shared<Galaxy>(systems, galaxySeed, galaxyWorkers(systems));
+    rng.reseed(galaxy->getSeed());
+    setupGame(setup);
+}
 
-    return "Saved to " + path;
+ThreadPool* Game::galaxyWorkers(int systems) {
+    return systems >= kParallelGalaxySystems ? &getWorkers() : nullptr;
 }
 
-std::string Game::quickLoad(const std::string& path) {
-    std::ifstream in(path);
-    if (!in.is_open()) {
-        return "Cannot load: failed to open file: " + path;
-    }
-
-    std::string header;
-    std::getline(in, header);
-    header = trim(header);
-    if (header != "AURORA_SAVE_V1") {
-        return "Cannot load: invalid save header";
-    }
-
-    struct SavedShip { std::string name; ShipClass cls{ShipClass::SCOUT}; int hull{0}; int shields{0}; };
-    struct SavedFleet { std::string name; std::string system; std::vector<SavedShip> ships; };
-    struct SavedColony { std::string name; std::string system; std::string planet; int pop{10}; int mines{0}; int factories{0}; };
-    struct SavedTech { std::string id; int progress{0}; bool researched{false}; };
-    struct SavedEmpire {
-        std::string name;
-        int turn{0};
-        std::string currentResearch;
-        std::string resources;
-        std::vector<SavedTech> techs;
-        std::vector<SavedColony> colonies;
-        std::vector<SavedFleet> fleets;
-    };
-    struct SavedHostile {
-        SavedEmpire e;
-        bool contacted{false};
-        bool atWar{false};
-    };
+ThreadPool& Game::getWorkers() {
+    if (!workers) workers = std::make_unique<ThreadPool>();
+    return *workers;
+}
 
-    uint32_t seed = 0;
-    int numSystems = 20;
-    std::vector<std::string> exploredSystems;
-    SavedEmpire player;
-    std::vector<SavedHostile> hostiles;
+BattlePrediction Game::predictBattle(const std::shared_ptr<Fleet>& attacker, const std::shared_ptr<Fleet>& defender,
+                                     int samples, int maxRounds) {
+    if (!attacker || !defender) return BattlePrediction{};
+    // One draw per prediction keys all of its trials.
+    const uint64_t predictionSeed = rng.stream(RngStreamId::PREDICTION)();
+    return predictBattleOutcome(*attacker, *defender, samples, maxRounds, predictionSeed, getWorkers());
+}
 
-    enum class Section { None, Player, Explored, Colonies, Fleets, Hostiles, Hostile };
-    Section section = Section::None;
-    SavedHostile* curHostile = nullptr;
-    SavedFleet* curFleet = nullptr;
+SaveData Game::captureSaveData() const {
+    SaveData data;
+    if (!empire || !galaxy) return data;
 
-    auto& curEmpire = [&]() -> SavedEmpire& {
-        if (section == Section::Hostile && curHostile) return curHostile->e;
-        return player;
-    };
+    data.seed = galaxy->getSeed();
+    data.numSystems = static_cast<int>(galaxy->getSystems().size());
+    data.galaxyGenerator = galaxy->getGenerator();
+    data.haveRngState = true;
+    data.rngSeed = rng.getSeed();
+    for (std::size_t i = 0; i < static_cast<std::size_t>(RngStreamId::COUNT); ++i) {
+        const auto id = static_cast<RngStreamId>(i);
+        data.rngCounters.emplace_back(id, rng.stream(id).getCounter());
+    }
 
-    std::string line;
-    while (std::getline(in, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
-        if (line[0] == '#') continue;
-
-        if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
-            const std::string tag = line.substr(1, line.size() - 2);
-            if (tag == "Player") { section = Section::Player; curHostile = nullptr; curFleet = nullptr; }
-            else if (tag == "Explored") { section = Section::Explored; curHostile = nullptr; curFleet = nullptr; }
-            else if (tag == "Colonies") { section = Section::Colonies; curHostile = nullptr; curFleet = nullptr; }
-            else if (tag == "Fleets") { section = Section::Fleets; curHostile = nullptr; curFleet = nullptr; }
-            else if (tag == "Hostiles") { section = Section::Hostiles; curHostile = nullptr; curFleet = nullptr; }
-            else if (tag == "Hostile") {
-                section = Section::Hostile;
-                hostiles.push_back(SavedHostile{});
-                curHostile = &hostiles.back();
-                curFleet = nullptr;
-            }
-            continue;
-        }
+    captureEmpire(*galaxy, *empire, data.player);
 
-        const auto kv = split(line, '=');
-        if (kv.size() < 2) {
-            if (line == "endfleet") {
-                curFleet = nullptr;
-                continue;
-            }
-            if (line == "endhostile") {
-                curHostile = nullptr;
-                section = Section::Hostiles;
-                curFleet = nullptr;
-                continue;
-            }
-            continue;
-        }
+    data.exploredSystems.reserve(exploration.exploredCount(kPlayerEmpireId));
+    for (const SystemId id : exploration.exploredSystems(kPlayerEmpireId)) {
+        data.exploredSystems.push_back(galaxy->getSystem(id)->getNameId());
+    }
 
-        const std::string key = trim(kv[0]);
-        const std::string value = trim(line.substr(line.find('=') + 1));
+    for (const auto& h : hostileEmpires) {
+        if (!h) continue;
+        SavedHostile sh;
+        captureEmpire(*galaxy, *h, sh.e);
+        sh.contacted = isHostileContacted(h->getId());
+        sh.atWar = isHostileAtWar(h->getId());
+        data.hostiles.push_back(std::move(sh));
+    }
+    return data;
+}
 
-        if (section == Section::None) {
-            if (key == "seed") {
-                int tmp = 0;
-                if (parseInt(value, tmp)) seed = static_cast<uint32_t>(tmp);
-            } else if (key == "numSystems") {
-                int tmp = 0;
-                if (parseInt(value, tmp)) numSystems = tmp;
-            }
-            continue;
-        }
+std::string Game::quickSave(const std::string& path, SaveFormat format) const {
+    PROFILE_SCOPE("Game::quickSave");
+    if (!empire || !galaxy) return "Cannot save: game not initialized";
 
-        if (section == Section::Explored) {
-            if (key == "system") exploredSystems.push_back(value);
-            continue;
-        }
+    const std::string error = writeSaveFileAtomic(captureSaveData(), path, format);
+    if (!error.empty()) return error;
+    return "Saved to " + path;
+}
 
-        if (section == Section::Player || section == Section::Hostile || section == Section::Colonies || section == Section::Fleets) {
-            SavedEmpire* ePtr = nullptr;
-            if (section == Section::Hostile && curHostile) {
-                ePtr = &curHostile->e;
-            } else {
-                // Player sections (including legacy [Colonies]/[Fleets])
-                ePtr = &player;
-            }
+void Game::setAutosave(int everyTurns, const std::string& path, SaveFormat format) {
+    autosaveInterval = std::max(0, everyTurns);
+    autosavePath = path;
+    autosaveFormat = format;
+    if (autosaveInterval > 0 && !autosaver) autosaver = std::make_unique<AutosaveWriter>();
+}
 
-            auto& e = *ePtr;
-            if (key == "name") e.name = value;
-            else if (key == "turn") { int t = 0; if (parseInt(value, t)) e.turn = t; }
-            else if (key == "currentResearch") e.currentResearch = value;
-            else if (key == "resources") e.resources = value;
-            else if (key == "contacted" && curHostile) { int v = 0; if (parseInt(value, v)) curHostile->contacted = (v != 0); }
-            else if (key == "atWar" && curHostile) { int v = 0; if (parseInt(value, v)) curHostile->atWar = (v != 0); }
-            else if (key == "tech") {
-                const auto parts = split(value, ',');
-                if (parts.size() >= 3) {
-                    SavedTech t;
-                    t.id = trim(parts[0]);
-                    parseInt(trim(parts[1]), t.progress);
-                    int rf = 0;
-                    parseInt(trim(parts[2]), rf);
-                    t.researched = (rf != 0);
-                    e.techs.push_back(std::move(t));
-                }
-            } else if (key == "colony") {
-                SavedColony c;
-                // Parse semicolon-delimited k=v pairs with the first token being the name.
-                const auto toks = split(value, ';');
-                c.name = trim(toks[0]);
-                for (size_t i = 1; i < toks.size(); ++i) {
-                    const auto kv2 = split(toks[i], '=');
-                    if (kv2.size() != 2) continue;
-                    const std::string k2 = trim(kv2[0]);
-                    const std::string v2 = trim(kv2[1]);
-                    if (k2 == "system") c.system = v2;
-                    else if (k2 == "planet") c.planet = v2;
-                    else if (k2 == "pop") parseInt(v2, c.pop);
-                    else if (k2 == "mines") parseInt(v2, c.mines);
-                    else if (k2 == "factories") parseInt(v2, c.factories);
-                }
-                e.colonies.push_back(std::move(c));
-            } else if (key == "fleet") {
-                SavedFleet f;
-                const auto toks = split(value, ';');
-                f.name = trim(toks[0]);
-                for (size_t i = 1; i < toks.size(); ++i) {
-                    const auto kv2 = split(toks[i], '=');
-                    if (kv2.size() != 2) continue;
-                    if (trim(kv2[0]) == "system") f.system = trim(kv2[1]);
-                }
-                e.fleets.push_back(std::move(f));
-                curFleet = &e.fleets.back();
-            } else if (key == "ship" && curFleet) {
-                SavedShip sship;
-                const auto toks = split(value, ';');
-                sship.name = trim(toks[0]);
-                for (size_t i = 1; i < toks.size(); ++i) {
-                    const auto kv2 = split(toks[i], '=');
-                    if (kv2.size() != 2) continue;
-                    const std::string k2 = trim(kv2[0]);
-                    const std::string v2 = trim(kv2[1]);
-                    if (k2 == "class") {
-                        ShipClass sc;
-                        if (shipClassFromString(v2, sc)) sship.cls = sc;
-                    } else if (k2 == "hull") {
-                        parseInt(v2, sship.hull);
-                    } else if (k2 == "shields") {
-                        parseInt(v2, sship.shields);
-                    }
-                }
-                curFleet->ships.push_back(std::move(sship));
-            }
-            continue;
-        }
-    }
+std::string Game::flushAutosave() {
+    if (!autosaver) return {};
+    autosaver->flush();
+    return autosaver->getLastResult();
+}
 
+std::string Game::quickLoad(const std::string& path) {
+    PROFILE_SCOPE("Game::quickLoad");
+    SaveData data;
+    const std::string error = readSaveFile(path, data);
+    if (!error.empty()) return error;
+
+    restoreSaveData(data);
+    return "Loaded from " + path;
+}
+
+void Game::restoreSaveData(const SaveData& data) {
     // Construct fresh world from seed.
-    auto newGalaxy = std::make_shared<Galaxy>(numSystems, seed);
-    for (const auto& sysName : exploredSystems) {
-        if (auto sys = newGalaxy->findSystemByName(sysName)) sys->explore();
+    auto newGalaxy = std::make_shared<Galaxy>(data.numSystems, data.seed, galaxyWorkers(data.numSystems),
+                                              data.galaxyGenerator);
+    ExplorationMap newExploration(data.hostiles.size() + 1, newGalaxy->getSystems().size());
+    newExploration.explore(kPlayerEmpireId, newGalaxy->getHomeSystem().getId());
+    for (const NameId sysName : data.exploredSystems) {
+        if (auto sys = newGalaxy->findSystemByName(nameOf(sysName))) {
+            newExploration.explore(kPlayerEmpireId, sys->getId());
+        }
     }
 
-    auto buildEmpireFromSaved = [&](const SavedEmpire& se, const std::string& ownerName) -> std::shared_ptr<Empire> {
-        auto e = std::make_shared<Empire>(ownerName);
+    // Ids are not saved; handing them out again in save order rebuilds the
+    // same relations.
+    colonyIds.reset();
+    fleetIds.reset();
+    shipIds.reset();
+
+    auto buildEmpireFromSaved = [&](const SavedEmpire& se, const std::string& ownerName,
+                                    EmpireId id) -> std::shared_ptr<Empire> {
+        auto e = std::make_shared<Empire>(ownerName, id);
         e->setTurnForLoad(se.turn);
-        applyResourcesForLoad(e->getResources(), se.resources);
+        for (const auto& r : se.resources) e->getResources().set(r.first, r.second);
         for (const auto& t : se.techs) {
             e->getResearch().setTechStateForLoad(t.id, t.progress, t.researched);
         }
@@ -557,22 +441,22 @@ std::string Game::quickLoad(const std::string& path) {
 
         // Colonies
         for (const auto& c : se.colonies) {
-            auto sys = newGalaxy->findSystemByName(c.system);
+            auto sys = newGalaxy->findSystemByName(nameOf(c.system));
             auto planet = findPlanetInSystem(sys, c.planet);
             if (!planet) continue;
-            auto colony = std::make_shared<Colony>(c.name, planet);
+            auto colony = std::make_shared<Colony>(colonyIds.allocate(), c.name, *planet);
             colony->setPopulationForLoad(c.pop);
             colony->setMinesForLoad(c.mines);
             colony->setFactoriesForLoad(c.factories);
-            planet->colonize(colony);
+            planet->colonize(colony->getId());
             e->addColony(colony);
         }
 
         // Fleets
         for (const auto& f : se.fleets) {
-            auto fleet = std::make_shared<Fleet>(f.name, ownerName);
-            if (!f.system.empty()) {
-                fleet->setLocation(newGalaxy->findSystemByName(f.system));
+            auto fleet = std::make_shared<Fleet>(f.name, id, fleetIds.allocate());
+            if (f.system != kNoName) {
+                if (auto sys = newGalaxy->findSystemByName(nameOf(f.system))) fleet->setLocation(sys->getId());
             }
             for (const auto& sh : f.ships) {
                 auto ship = makeNamedShipForClass(*e, sh.name, sh.cls);
@@ -590,7 +474,7 @@ std::string Game::quickLoad(const std::string& path) {
                         const int dmg = maxS + (maxH - wantH);
                         if (dmg > 0) ship->takeDamage(dmg);
                     }
-                    fleet->addShip(ship);
+                    addShipTo(*fleet, ship);
                 }
             }
             e->addFleet(fleet);
@@ -599,37 +483,42 @@ std::string Game::quickLoad(const std::string& path) {
         return e;
     };
 
-    if (player.name.empty()) player.name = "Earth Empire";
-    auto newEmpire = buildEmpireFromSaved(player, player.name);
+    const std::string playerName = data.player.name.empty() ? "Earth Empire" : data.player.name;
+    auto newEmpire = buildEmpireFromSaved(data.player, playerName, kPlayerEmpireId);
 
     std::vector<std::shared_ptr<Empire>> newHostiles;
-    std::map<std::string, bool> newContacted;
-    std::map<std::string, bool> newAtWar;
+    DiplomacyMatrix newDiplomacy(data.hostiles.size() + 1);
 
-    for (const auto& h : hostiles) {
+    for (const auto& h : data.hostiles) {
         const std::string name = h.e.name.empty() ? "Hostile" : h.e.name;
-        auto e = buildEmpireFromSaved(h.e, name);
+        const EmpireId id = static_cast<EmpireId>(newHostiles.size() + 1);
+        auto e = buildEmpireFromSaved(h.e, name, id);
         newHostiles.push_back(e);
-        newContacted[name] = h.contacted;
-        newAtWar[name] = h.atWar;
+        newDiplomacy.setContact(kPlayerEmpireId, id, h.contacted);
+        if (h.atWar) newDiplomacy.setStance(kPlayerEmpireId, id, DiplomaticStance::WAR);
     }
 
     empire = newEmpire;
     galaxy = newGalaxy;
     hostileEmpires = std::move(newHostiles);
-    hostileContacted = std::move(newContacted);
-    hostileAtWar = std::move(newAtWar);
+    diplomacy = std::move(newDiplomacy);
+    exploration = std::move(newExploration);
+    indexHostiles();
 
-    return "Loaded from " + path;
+    // Older saves carry no RNG state; restart the streams from the galaxy seed.
+    rng.reseed(data.haveRngState ? data.rngSeed : galaxy->getSeed());
+    for (const auto& rc : data.rngCounters) {
+        rng.stream(rc.first).setCounter(rc.second);
+    }
 }
 
-void Game::setupGame() {
+void Game::setupGame(const GameSetup& setup) {
     // Colonize home planet (Earth)
-    auto homePlanets = galaxy->getHomeSystem()->getPlanets();
+    auto homePlanets = galaxy->getHomeSystem().getPlanets();
     if (homePlanets.size() >= 3) {
-        auto homePlanet = homePlanets[2];  // 3rd planet
-        auto earthColony = std::make_shared<Colony>("Earth", homePlanet);
-        homePlanet->colonize(earthColony);
+        Planet& homePlanet = homePlanets[2];  // 3rd planet
+        auto earthColony = std::make_shared<Colony>(colonyIds.allocate(), "Earth", homePlanet);
+        homePlanet.colonize(earthColony->getId());
         empire->addColony(earthColony);
     }
     
@@ -639,58 +528,137 @@ void Game::setupGame() {
 
     // Create hostile empires with their own starting fleets.
     // Minimal AI: they build up and sometimes attack on Advance Turn.
-    const auto& systems = galaxy->getSystems();
-    auto pickSystem = [&](std::size_t fallbackIndex) -> std::shared_ptr<StarSystem> {
-        if (!systems.empty()) {
-            const std::size_t idx = std::min(fallbackIndex, systems.size() - 1);
-            return systems[idx];
-        }
-        return galaxy->getHomeSystem();
-    };
-
-    struct AiSpec { const char* name; std::size_t sysIndex; };
-    const AiSpec specs[] = {
-        {"Zorg Collective", 5},
-        {"Krell Dominion", 8},
-    };
-
-    for (const auto& spec : specs) {
-        auto ai = std::make_shared<Empire>(spec.name);
-        auto fleet = std::make_shared<Fleet>(std::string(spec.name) + " Fleet", ai->getName());
-        fleet->addShip(makeShipForClass(*ai, "Raider", ShipClass::CORVETTE, 1));
-        fleet->addShip(makeShipForClass(*ai, "Raider", ShipClass::SCOUT, 2));
-        fleet->setLocation(pickSystem(spec.sysIndex));
+    const int aiCount = std::max(0, setup.aiCount);
+    const auto homeworlds = placeHomeworlds(aiCount, setup.placement);
+    hostileEmpires.reserve(static_cast<std::size_t>(aiCount));
+
+    diplomacy.reset(static_cast<std::size_t>(aiCount) + 1);
+    exploration.reset(static_cast<std::size_t>(aiCount) + 1, galaxy->getSystems().size());
+    exploration.explore(kPlayerEmpireId, galaxy->getHomeSystem().getId());
+
+    for (int i = 0; i < aiCount; ++i) {
+        auto ai = std::make_shared<Empire>(aiEmpireName(i), static_cast<EmpireId>(i + 1));
+        auto fleet = std::make_shared<Fleet>(ai->getName() + " Fleet", ai->getId(), fleetIds.allocate());
+        addShipTo(*fleet, makeShipForClass(*ai, "Raider", ShipClass::CORVETTE, 1));
+        addShipTo(*fleet, makeShipForClass(*ai, "Raider", ShipClass::SCOUT, 2));
+        StarSystem* sys = galaxy->getSystem(homeworlds[static_cast<std::size_t>(i)]);
+        fleet->setLocation(sys->getId());
         ai->addFleet(fleet);
         hostileEmpires.push_back(ai);
 
-        hostileContacted[ai->getName()] = false;
-        hostileAtWar[ai->getName()] = false;
-
         // Give each hostile a starting colony on a colonizable planet in its system (if any).
-        if (auto sys = fleet->getLocation()) {
+        {
             auto colonizable = sys->getColonizablePlanets();
             if (!colonizable.empty()) {
                 auto planet = colonizable[0];
-                auto colony = std::make_shared<Colony>(std::string(spec.name) + " Prime", planet);
-                planet->colonize(colony);
+                auto colony = std::make_shared<Colony>(colonyIds.allocate(), ai->getName() + " Prime", *planet);
+                planet->colonize(colony->getId());
                 ai->addColony(colony);
             }
         }
     }
+    indexHostiles();
+}
+
+void Game::indexHostiles() {
+    hostilesByName.clear();
+    hostilesByName.reserve(hostileEmpires.size());
+    for (const auto& h : hostileEmpires) hostilesByName.insert(h);
+}
+
+void Game::addShipTo(Fleet& fleet, std::shared_ptr<Ship> ship) {
+    ship->setId(shipIds.allocate());
+    fleet.addShip(std::move(ship));
+}
+
+std::shared_ptr<Empire> Game::getEmpireById(EmpireId id) const {
+    if (id == kPlayerEmpireId) return empire;
+    return id <= hostileEmpires.size() ? hostileEmpires[id - 1] : nullptr;
+}
+
+std::vector<SystemId> Game::placeHomeworlds(int count, HomeworldPlacement placement) const {
+    const auto systems = galaxy->getSystems();
+    std::vector<SystemId> result;
+    result.reserve(static_cast<std::size_t>(count));
+    // Sol is the player's; a one-system galaxy has nowhere else to go.
+    if (systems.size() < 2) {
+        result.assign(static_cast<std::size_t>(count), galaxy->getHomeSystem().getId());
+        return result;
+    }
+
+    if (placement == HomeworldPlacement::RANDOM) {
+        RandomStream placementRng(rngDeriveKey(galaxy->getSeed(), 0x484F4D45 /* "HOME" */));
+        std::vector<std::size_t> pool;
+        for (int i = 0; i < count; ++i) {
+            // Distinct systems until every one is taken, then start over.
+            if (pool.empty()) {
+                pool.resize(systems.size() - 1);
+                for (std::size_t s = 0; s < pool.size(); ++s) pool[s] = s + 1;
+            }
+            const std::size_t pick = placementRng.below(pool.size());
+            result.push_back(static_cast<SystemId>(pool[pick]));
+            pool[pick] = pool.back();
+            pool.pop_back();
+        }
+        return result;
+    }
+
+    // Farthest-point sampling; minDist2 holds each system's squared distance to
+    // the nearest homeworld placed so far, Sol included. O(systems * count).
+    const std::size_t n = systems.size();
+    std::vector<int64_t> minDist2(n);
+    std::vector<char> habitable(n);
+    const StarSystem& home = galaxy->getHomeSystem();
+    auto dist2 = [](const StarSystem& a, const StarSystem& b) {
+        const int64_t dx = a.getX() - b.getX();
+        const int64_t dy = a.getY() - b.getY();
+        const int64_t dz = a.getZ() - b.getZ();
+        return dx * dx + dy * dy + dz * dz;
+    };
+    for (std::size_t s = 0; s < n; ++s) {
+        minDist2[s] = &systems[s] == &home ? -1 : dist2(systems[s], home);
+        habitable[s] = systems[s].hasColonizablePlanet();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        // Ties go to the lower index; habitable systems beat any uninhabitable one.
+        std::size_t best = n;
+        for (std::size_t s = 0; s < n; ++s) {
+            if (minDist2[s] < 0) continue;
+            if (best == n || habitable[s] > habitable[best] ||
+                (habitable[s] == habitable[best] && minDist2[s] > minDist2[best])) {
+                best = s;
+            }
+        }
+        if (best == n) {
+            // More AIs than free systems: share, again spreading from scratch.
+            for (std::size_t s = 0; s < n; ++s) {
+                minDist2[s] = &systems[s] == &home ? -1 : dist2(systems[s], home);
+            }
+            --i;
+            continue;
+        }
+        result.push_back(static_cast<SystemId>(best));
+        minDist2[best] = -1;
+        for (std::size_t s = 0; s < n; ++s) {
+            if (minDist2[s] > 0) minDist2[s] = std::min(minDist2[s], dist2(systems[s], systems[best]));
+        }
+    }
+    return result;
 }
 
 bool Game::isHostileContacted(const std::string& hostileName) const {
-    auto it = hostileContacted.find(hostileName);
-    return it != hostileContacted.end() ? it->second : false;
+    auto h = hostilesByName.find(hostileName);
+    return h && isHostileContacted(h->getId());
 }
 
 bool Game::isHostileAtWar(const std::string& hostileName) const {
-    auto it = hostileAtWar.find(hostileName);
-    return it != hostileAtWar.end() ? it->second : false;
+    auto h = hostilesByName.find(hostileName);
+    return h && isHostileAtWar(h->getId());
 }
 
 std::shared_ptr<Fleet> Game::createStartingFleet() {
-    auto fleet = std::make_shared<Fleet>("Home Defense Fleet", empire->getName());
+    auto fleet = std::make_shared<Fleet>("Home Defense Fleet", empire->getId(), fleetIds.allocate());
     
     // Add basic ships
     Weapon laser("Laser Cannon", 10, 0.7, 5);
@@ -700,133 +668,149 @@ std::shared_ptr<Fleet> Game::createStartingFleet() {
     auto corvette = std::make_shared<Ship>("Corvette-1", ShipClass::CORVETTE, 100, 50,
                                           std::vector<Weapon>{laser, laser});
     
-    fleet->addShip(scout);
-    fleet->addShip(corvette);
-    fleet->setLocation(galaxy->getHomeSystem());
+    addShipTo(*fleet, scout);
+    addShipTo(*fleet, corvette);
+    fleet->setLocation(galaxy->getHomeSystem().getId());
     
     return fleet;
 }
 
 std::string Game::advanceTurn() {
+    PROFILE_SCOPE("Game::advanceTurn");
+    const bool narrate = narrative;
     std::ostringstream log;
-    log << empire->advanceTurn();
-
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<> chance(0.0, 1.0);
+    const std::string playerTurn = empire->advanceTurn();
+    if (narrate) log << playerTurn;
+
+    // Decide/produce: each AI only touches its own empire and its own RNG
+    // stream, keyed by (turn, AI index), so this phase may run in any order.
+    const std::size_t aiCount = hostileEmpires.size();
+    const uint64_t turnKey = static_cast<uint64_t>(empire->getTurn()) << 32;
+    std::vector<AiTurnState> aiStates(aiCount);
+    auto decideRange = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (!hostileEmpires[i]) continue;
+            aiStates[i].rng = rng.fork(RngStreamId::AI_TURN, turnKey | i);
+            aiDecideTurn(*hostileEmpires[i], aiStates[i], narrate);
+        }
+    };
+    if (parallelAi && aiCount > kAiSerialThreshold) {
+        getWorkers().parallelFor(aiCount, decideRange);
+    } else {
+        decideRange(0, aiCount);
+    }
 
-    // Hostile empires take their turns.
-    for (auto& ai : hostileEmpires) {
+    // Resolve: everything that touches shared state (planets, the player,
+    // other empires) runs serially in AI order.
+    for (std::size_t i = 0; i < aiCount; ++i) {
+        auto& ai = hostileEmpires[i];
         if (!ai) continue;
+        PROFILE_SCOPE("AI resolve");
+        AiTurnState& st = aiStates[i];
+        RandomStream& aiRng = st.rng;
 
-        int builtShips = 0;
         int colonizedPlanets = 0;
-        bool startedResearch = false;
         bool attacked = false;
-        std::string startedResearchName;
 
-        log << "\n";
-        log << "[Hostile] " << ai->getName() << ": " << ai->advanceTurn();
-
-        // If not researching anything, pick the first available tech.
-        if (ai->getCurrentResearch().empty()) {
-            auto available = ai->getResearch().getAvailableTechs();
-            if (!available.empty() && available[0]) {
-                ai->setResearch(available[0]->getId());
-                startedResearch = true;
-                startedResearchName = available[0]->getName();
+        if (narrate) {
+            log << "\n";
+            log << "[Hostile] " << ai->getName() << ": " << st.turnReport;
+            if (st.startedResearch) {
                 log << "\n";
-                log << "[Hostile] " << ai->getName() << " starts research: " << available[0]->getName() << ".";
+                log << "[Hostile] " << ai->getName() << " starts research: " << st.startedResearchName << ".";
             }
         }
 
-        // Basic colonization: sometimes colonize another colonizable planet in its home system.
-        if (chance(gen) < 0.25) {
-            if (!ai->getFleets().empty() && ai->getFleets()[0] && ai->getFleets()[0]->getLocation()) {
-                auto sys = ai->getFleets()[0]->getLocation();
+        // Basic colonization: colonize another colonizable planet in its home
+        // system. Picked here, not in the decide phase, so two empires sharing
+        // a system never claim the same planet.
+        if (st.wantsColony) {
+            PROFILE_SCOPE("AI colonization");
+            StarSystem* sys = !ai->getFleets().empty() && ai->getFleets()[0]
+                                  ? galaxy->getSystem(ai->getFleets()[0]->getLocation())
+                                  : nullptr;
+            if (sys) {
                 auto colonizable = sys->getColonizablePlanets();
                 if (!colonizable.empty()) {
                     auto planet = colonizable[0];
-                    auto colony = std::make_shared<Colony>(ai->getName() + " Colony " + planet->getName(), planet);
-                    planet->colonize(colony);
+                    auto colony = std::make_shared<Colony>(colonyIds.allocate(),
+                                                           ai->getName() + " Colony " + planet->getName(), *planet);
+                    planet->colonize(colony->getId());
                     ai->addColony(colony);
                     colonizedPlanets++;
-                    log << "\n";
-                    log << "[Hostile] " << ai->getName() << " colonizes " << planet->getName() << ".";
+                    if (narrate) {
+                        log << "\n";
+                        log << "[Hostile] " << ai->getName() << " colonizes " << planet->getName() << ".";
+                    }
                 }
             }
         }
 
-        // AI shipbuilding (simple): sometimes add a ship to its first fleet.
-        auto& aiFleets = ai->getFleets();
-        if (!aiFleets.empty() && aiFleets[0]) {
-            if (chance(gen) < 0.45) {
-                ShipClass build = aiPickBuildClass(ai->getTurn(), gen);
-                const int shipIndex = static_cast<int>(aiFleets[0]->getShips().size() + 1);
-                aiFleets[0]->addShip(makeShipForClass(*ai, ai->getName(), build, shipIndex));
-                builtShips++;
-                log << "\n";
-                log << "[Hostile] " << ai->getName() << " builds a " << shipClassToString(build) << ".";
-            }
+        if (st.builtShip) st.builtShip->setId(shipIds.allocate());
+        if (narrate && st.builtShips > 0) {
+            log << "\n";
+            log << "[Hostile] " << ai->getName() << " builds a " << shipClassToString(st.builtClass) << ".";
         }
 
         // AI attacks: occasionally simulate a battle against a random player fleet.
-        if (isHostileAtWar(ai->getName()) && chance(gen) < 0.25) {
-            auto aiFleet = pickRandomOperationalFleet(ai->getFleets(), gen);
-            auto playerFleet = pickRandomOperationalFleet(empire->getFleets(), gen);
+        if (isHostileAtWar(ai->getId()) && aiRng.chance(0.25)) {
+            auto aiFleet = pickRandomOperationalFleet(ai->getFleets(), aiRng);
+            auto playerFleet = pickRandomOperationalFleet(empire->getFleets(), aiRng);
             if (aiFleet && playerFleet) {
+                PROFILE_SCOPE("AI combat");
                 attacked = true;
                 const int attackerHP0 = fleetTotalHP(aiFleet);
                 const int defenderHP0 = fleetTotalHP(playerFleet);
                 const int attackerShips0 = fleetShipCount(aiFleet);
                 const int defenderShips0 = fleetShipCount(playerFleet);
 
-                Combat combat(aiFleet, playerFleet);
+                // Nobody replays AI battles frame by frame; keep compact events only.
+                Combat combat(aiFleet, playerFleet, rng.stream(RngStreamId::COMBAT),
+                              narrate ? CombatRecording::SUMMARY : CombatRecording::NONE);
                 auto winner = combat.resolve(6);
 
-                log << "\n\n";
-                log << "[Hostile Attack] " << ai->getName() << " attacks " << empire->getName() << "!\n";
-                log << "Attacker: " << aiFleet->getName() << " vs Defender: " << playerFleet->getName() << "\n";
-                log << "Pre-battle HP: " << attackerHP0 << " vs " << defenderHP0 << "\n";
-                for (const auto& line : combat.getLog()) {
-                    log << line << "\n";
+                if (narrate) {
+                    log << "\n\n";
+                    log << "[Hostile Attack] " << ai->getName() << " attacks " << empire->getName() << "!\n";
+                    log << "Attacker: " << aiFleet->getName() << " vs Defender: " << playerFleet->getName() << "\n";
+                    log << "Pre-battle HP: " << attackerHP0 << " vs " << defenderHP0 << "\n";
+                    for (const auto& line : combat.getLog()) {
+                        log << line << "\n";
+                    }
                 }
                 if (winner) {
-                    const int attackerShips1 = fleetShipCount(aiFleet);
-                    const int defenderShips1 = fleetShipCount(playerFleet);
-                    log << "Winner: " << winner->getName() << "\n";
-                    log << "Post-battle ships: " << attackerShips1 << "/" << attackerShips0
-                        << " vs " << defenderShips1 << "/" << defenderShips0;
+                    if (narrate) {
+                        const int attackerShips1 = fleetShipCount(aiFleet);
+                        const int defenderShips1 = fleetShipCount(playerFleet);
+                        log << "Winner: " << winner->getName() << "\n";
+                        log << "Post-battle ships: " << attackerShips1 << "/" << attackerShips0
+                            << " vs " << defenderShips1 << "/" << defenderShips0;
+                    }
 
                     // Salvage: winner gets minerals based on defeated side initial HP.
                     int salvage = 0;
                     if (winner.get() == aiFleet.get()) salvage = defenderHP0 / 10;
                     if (winner.get() == playerFleet.get()) salvage = attackerHP0 / 10;
                     if (salvage > 0) {
-                        if (winner->getOwner() == empire->getName()) {
-                            empire->getResources().add(ResourceType::MINERALS, salvage);
-                        } else {
-                            for (auto& h : hostileEmpires) {
-                                if (h && h->getName() == winner->getOwner()) {
-                                    h->getResources().add(ResourceType::MINERALS, salvage);
-                                    break;
-                                }
-                            }
+                        if (auto owner = getEmpireById(winner->getOwner())) {
+                            owner->getResources().add(ResourceType::MINERALS, salvage);
                         }
-                        log << "\nSalvage gained: " << salvage << " Minerals";
+                        if (narrate) log << "\nSalvage gained: " << salvage << " Minerals";
                     }
                 }
             }
         }
 
+        if (!narrate) continue;
+
         // Compact summary line (in addition to any detailed log above)
         log << "\n";
         log << "[Hostile Summary] " << ai->getName() << ": ";
-        if (startedResearch) {
-            log << "Researching " << startedResearchName << "; ";
+        if (st.startedResearch) {
+            log << "Researching " << st.startedResearchName << "; ";
         }
-        log << "Built " << builtShips << ", Colonized " << colonizedPlanets;
-        if (isHostileAtWar(ai->getName())) {
+        log << "Built " << st.builtShips << ", Colonized " << colonizedPlanets;
+        if (isHostileAtWar(ai->getId())) {
             log << ", War: Yes";
         } else {
             log << ", War: No";
@@ -838,61 +822,62 @@ std::string Game::advanceTurn() {
         }
     }
 
+    // Planets looked at this turn but never colonized are regenerated on
+    // next use.
+    galaxy->evictUntouchedDetails();
+
+    // Capturing is a plain copy of the state; formatting and disk I/O happen
+    // on the autosave thread.
+    if (autosaveInterval > 0 && empire->getTurn() % autosaveInterval == 0) {
+        PROFILE_SCOPE("Autosave snapshot");
+        autosaver->submit(captureSaveData(), autosavePath, autosaveFormat);
+    }
+
     return log.str();
 }
 
 std::string Game::exploreSystem(const std::string& systemName) {
-    const auto toLowerChar = [](unsigned char c) {
-        return static_cast<char>(std::tolower(c));
-    };
+    auto system = galaxy->findSystemByName(systemName);
+    if (!system) {
+        return "System not found";
+    }
 
-    for (auto& system : galaxy->getSystems()) {
-        std::string sysNameLower = system->getName();
-        std::string searchNameLower = systemName;
-        std::transform(sysNameLower.begin(), sysNameLower.end(), sysNameLower.begin(), toLowerChar);
-        std::transform(searchNameLower.begin(), searchNameLower.end(), searchNameLower.begin(), toLowerChar);
-        
-        if (sysNameLower == searchNameLower) {
-            const bool wasExplored = system->isExplored();
-            system->explore();
-
-            // Check for hostile presence and trigger contact/war.
-            for (const auto& h : hostileEmpires) {
-                if (!h) continue;
-                for (const auto& f : h->getFleets()) {
-                    if (f && f->getLocation() == system) {
-                        hostileContacted[h->getName()] = true;
-                        hostileAtWar[h->getName()] = true;
-                    }
-                }
+    const bool wasExplored = !exploration.explore(kPlayerEmpireId, system->getId());
+
+    // Check for hostile presence and trigger contact/war.
+    for (const auto& h : hostileEmpires) {
+        if (!h) continue;
+        for (const auto& f : h->getFleets()) {
+            if (f && f->getLocation() == system->getId()) {
+                diplomacy.setContact(kPlayerEmpireId, h->getId(), true);
+                diplomacy.setStance(kPlayerEmpireId, h->getId(), DiplomaticStance::WAR);
             }
+        }
+    }
 
-            if (!wasExplored) {
-                const int reward = 10 + static_cast<int>(system->getPlanets().size()) * 2;
-                empire->getResources().add(ResourceType::RESEARCH_POINTS, reward);
-                std::string msg = "Explored " + system->getName() + "! Found " +
-                                  std::to_string(system->getPlanets().size()) + " planets. Gained " +
-                                  std::to_string(reward) + " research points.";
-
-                for (const auto& h : hostileEmpires) {
-                    if (!h) continue;
-                    if (isHostileContacted(h->getName()) && isHostileAtWar(h->getName())) {
-                        // If contact was just made in this system, this will already be set.
-                        for (const auto& f : h->getFleets()) {
-                            if (f && f->getLocation() == system) {
-                                msg += "\nContact! Hostile presence detected: " + h->getName() + " (WAR)";
-                            }
-                        }
+    if (!wasExplored) {
+        const int reward = 10 + static_cast<int>(system->getPlanetCount()) * 2;
+        empire->getResources().add(ResourceType::RESEARCH_POINTS, reward);
+        std::string msg = "Explored " + system->getName() + "! Found " +
+                          std::to_string(system->getPlanetCount()) + " planets. Gained " +
+                          std::to_string(reward) + " research points.";
+
+        for (const auto& h : hostileEmpires) {
+            if (!h) continue;
+            if (isHostileContacted(h->getId()) && isHostileAtWar(h->getId())) {
+                // If contact was just made in this system, this will already be set.
+                for (const auto& f : h->getFleets()) {
+                    if (f && f->getLocation() == system->getId()) {
+                        msg += "\nContact! Hostile presence detected: " + h->getName() + " (WAR)";
                     }
                 }
-
-                return msg;
             }
-
-            return "System already explored: " + system->getName();
         }
+
+        return msg;
     }
-    return "System not found";
+
+    return "System already explored: " + system->getName();
 }
 
 std::string Game::startResearch(const std::string& techId) {
@@ -905,27 +890,13 @@ std::string Game::startResearch(const std::string& techId) {
     return "Cannot research that technology";
 }
 
-std::vector<std::shared_ptr<Technology>> Game::getAvailableResearch() {
+std::vector<Technology> Game::getAvailableResearch() {
     return empire->getResearch().getAvailableTechs();
 }
 
 std::string Game::buildShip(ShipClass shipClass, const std::string& fleetName) {
     // Find fleet
-    std::shared_ptr<Fleet> targetFleet;
-    std::string fleetNameLower = fleetName;
-    const auto toLowerChar = [](unsigned char c) {
-        return static_cast<char>(std::tolower(c));
-    };
-    std::transform(fleetNameLower.begin(), fleetNameLower.end(), fleetNameLower.begin(), toLowerChar);
-    
-    for (auto& fleet : empire->getFleets()) {
-        std::string fname = fleet->getName();
-        std::transform(fname.begin(), fname.end(), fname.begin(), toLowerChar);
-        if (fname == fleetNameLower) {
-            targetFleet = fleet;
-            break;
-        }
-    }
+    std::shared_ptr<Fleet> targetFleet = empire->findFleetByName(fleetName);
     
     if (!targetFleet) {
         return "Fleet not found";
@@ -938,27 +909,13 @@ std::string Game::buildShip(ShipClass shipClass, const std::string& fleetName) {
     std::shared_ptr<Ship> ship = makeShipForClass(*empire, shipClassToString(shipClass), shipClass,
                                                   static_cast<int>(targetFleet->getShips().size() + 1));
     
-    targetFleet->addShip(ship);
+    addShipTo(*targetFleet, ship);
     return "Built " + shipName + " and added to " + targetFleet->getName();
 }
 
 std::string Game::simulateCombat(const std::string& fleet1Name, const std::string& fleet2Name) {
-    std::shared_ptr<Fleet> fleet1, fleet2;
-
-    const auto toLowerChar = [](unsigned char c) {
-        return static_cast<char>(std::tolower(c));
-    };
-    
-    std::string f1Lower = fleet1Name, f2Lower = fleet2Name;
-    std::transform(f1Lower.begin(), f1Lower.end(), f1Lower.begin(), toLowerChar);
-    std::transform(f2Lower.begin(), f2Lower.end(), f2Lower.begin(), toLowerChar);
-    
-    for (auto& fleet : empire->getFleets()) {
-        std::string fname = fleet->getName();
-        std::transform(fname.begin(), fname.end(), fname.begin(), toLowerChar);
-        if (fname == f1Lower) fleet1 = fleet;
-        if (fname == f2Lower) fleet2 = fleet;
-    }
+    std::shared_ptr<Fleet> fleet1 = empire->findFleetByName(fleet1Name);
+    std::shared_ptr<Fleet> fleet2 = empire->findFleetByName(fleet2Name);
     
     if (!fleet1 || !fleet2) {
         return "One or both fleets not found";
@@ -969,7 +926,7 @@ std::string Game::simulateCombat(const std::string& fleet1Name, const std::strin
     const int ships1 = fleetShipCount(fleet1);
     const int ships2 = fleetShipCount(fleet2);
 
-    Combat combat(fleet1, fleet2);
+    Combat combat(fleet1, fleet2, rng.stream(RngStreamId::COMBAT));
     auto winner = combat.resolve();
 
     showBattleSprites("Battle: " + fleet1->getName() + " vs " + fleet2->getName(), combat.getFrames());
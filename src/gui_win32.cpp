@@ -80,8 +80,8 @@ struct AppState {
     HWND editLog{};
 
     // Cached data backing list/combos
-    std::vector<std::shared_ptr<Technology>> availableTechs;
-    std::vector<std::shared_ptr<StarSystem>> unexploredSystems;
+    std::vector<Technology> availableTechs;
+    std::vector<StarSystem*> unexploredSystems;
     std::vector<std::shared_ptr<Fleet>> fleets;
     std::vector<std::shared_ptr<Empire>> hostiles;
 
@@ -91,12 +91,12 @@ struct AppState {
     std::string selectedHostileName;
 };
 
-static bool systemHasHostiles(Game& game, const std::shared_ptr<StarSystem>& sys) {
+static bool systemHasHostiles(Game& game, const StarSystem* sys) {
     if (!sys) return false;
     for (const auto& h : game.getHostileEmpires()) {
         if (!h) continue;
         for (const auto& f : h->getFleets()) {
-            if (f && f->getLocation() == sys) return true;
+            if (f && f->getLocation() == sys->getId()) return true;
         }
     }
     return false;
@@ -315,15 +315,14 @@ static void refreshContent(AppState& s, bool resetLog) {
             s.availableTechs = s.game->getAvailableResearch();
             int restoreListIndex = -1;
             for (size_t i = 0; i < s.availableTechs.size(); ++i) {
-                auto tech = s.availableTechs[i];
-                if (!tech) continue;
+                const auto& tech = s.availableTechs[i];
                 std::ostringstream label;
-                label << tech->getName() << " (" << techCategoryToString(tech->getCategory())
-                      << ", Cost: " << tech->getCost() << " RP)";
+                label << tech.getName() << " (" << techCategoryToString(tech.getCategory())
+                      << ", Cost: " << tech.getCost() << " RP)";
                 int idx = (int)SendMessageA(s.listMain, LB_ADDSTRING, 0, (LPARAM)label.str().c_str());
                 SendMessageA(s.listMain, LB_SETITEMDATA, idx, (LPARAM)i);
 
-                if (!s.selectedTechId.empty() && tech->getId() == s.selectedTechId) {
+                if (!s.selectedTechId.empty() && tech.getId() == s.selectedTechId) {
                     restoreListIndex = idx;
                 }
             }
@@ -342,7 +341,10 @@ static void refreshContent(AppState& s, bool resetLog) {
             }
 
             auto galaxy = s.game->getGalaxy();
-            s.unexploredSystems = galaxy->getUnexploredSystems();
+            s.unexploredSystems.clear();
+            for (const SystemId id : s.game->getExploration().unexploredSystems(kPlayerEmpireId)) {
+                s.unexploredSystems.push_back(galaxy->getSystem(id));
+            }
             int restoreListIndex = -1;
             for (size_t i = 0; i < s.unexploredSystems.size(); ++i) {
                 auto sys = s.unexploredSystems[i];
@@ -446,8 +448,8 @@ static void snapshotListSelection(AppState& s) {
 
     switch (s.view) {
         case View::Research:
-            if (index < s.availableTechs.size() && s.availableTechs[index]) {
-                s.selectedTechId = s.availableTechs[index]->getId();
+            if (index < s.availableTechs.size()) {
+                s.selectedTechId = s.availableTechs[index].getId();
             }
             break;
         case View::Explore:
@@ -484,7 +486,7 @@ static void appendSelectionPreview(AppState& s) {
             auto sys = s.game->getGalaxy()->findSystemByName(s.selectedSystemName);
             if (!sys) return;
             std::ostringstream oss;
-            oss << "Selected system: " << sys->getName() << " (Planets " << sys->getPlanets().size() << ")";
+            oss << "Selected system: " << sys->getName() << " (Planets " << sys->getPlanetCount() << ")";
             if (systemHasHostiles(*s.game, sys)) oss << " [Hostiles]";
             appendLog(s, oss.str());
             break;
@@ -542,11 +544,11 @@ static void doAction(AppState& s) {
                 return;
             }
             size_t index = (size_t)SendMessageA(s.listMain, LB_GETITEMDATA, sel, 0);
-            if (index >= s.availableTechs.size() || !s.availableTechs[index]) {
+            if (index >= s.availableTechs.size()) {
                 appendLog(s, "Invalid selection.");
                 return;
             }
-            std::string result = s.game->startResearch(s.availableTechs[index]->getId());
+            std::string result = s.game->startResearch(s.availableTechs[index].getId());
             appendLog(s, "");
             appendLog(s, result);
             refreshContent(s, false);
@@ -52,11 +52,11 @@ void researchMenu(Game& game, UIManager& ui) {
         for (size_t i = 0; i < available.size() && i < 10; ++i) {
             auto tech = available[i];
             std::ostringstream label;
-            label << tech->getName() << " (" << techCategoryToString(tech->getCategory())
-                  << ", Cost: " << tech->getCost() << " RP)";
+            label << tech.getName() << " (" << techCategoryToString(tech.getCategory())
+                  << ", Cost: " << tech.getCost() << " RP)";
             
             researchItems.push_back(MenuItem(label.str(), [&game, tech, &ui]() {
-                std::string result = game.startResearch(tech->getId());
+                std::string result = game.startResearch(tech.getId());
                 ui.displayText(result, true);
             }));
         }
@@ -88,17 +88,19 @@ void researchMenu(Game& game, UIManager& ui) {
 
 void exploreMenu(Game& game, UIManager& ui) {
     auto galaxy = game.getGalaxy();
-    auto unexplored = galaxy->getUnexploredSystems();
+    const ExplorationMap& exploration = game.getExploration();
+    const auto unexplored = exploration.unexploredSystems(kPlayerEmpireId);
     
     std::ostringstream info;
-    info << "Explored Systems: " << galaxy->getExploredSystems().size() << "\n";
+    info << "Explored Systems: " << exploration.exploredCount(kPlayerEmpireId) << "\n";
     info << "Unexplored Systems: " << unexplored.size() << "\n\n";
     
     std::vector<MenuItem> exploreItems;
     
-    size_t showCount = std::min(unexplored.size(), size_t(10));
-    for (size_t i = 0; i < showCount; ++i) {
-        auto system = unexplored[i];
+    size_t shown = 0;
+    for (const SystemId id : unexplored) {
+        if (shown++ == 10) break;
+        StarSystem* system = galaxy->getSystem(id);
         std::ostringstream label;
         label << "Explore " << system->getName() << " (" << system->getX() << "," 
               << system->getY() << "," << system->getZ() << ")";
@@ -107,8 +109,8 @@ void exploreMenu(Game& game, UIManager& ui) {
             std::string result = game.exploreSystem(system->getName());
             std::ostringstream details;
             details << result << "\n\nPlanets found:\n";
-            for (const auto& planet : system->getPlanets()) {
-                details << "  " << planet->getName() << " (" << planet->getPlanetType() << ")\n";
+            for (const Planet& planet : system->getPlanets()) {
+                details << "  " << planet.getName() << " (" << planet.getPlanetType() << ")\n";
             }
             ui.displayText(details.str(), true);
         }));
@@ -132,7 +134,8 @@ void fleetMenu(Game& game, UIManager& ui) {
     for (size_t i = 0; i < fleets.size(); ++i) {
         auto fleet = fleets[i];
         info << (i + 1) << ". " << fleet->getName() << "\n";
-        info << "   Location: " << (fleet->getLocation() ? fleet->getLocation()->getName() : "Unknown") << "\n";
+        auto location = game.getGalaxy()->getSystem(fleet->getLocation());
+        info << "   Location: " << (location ? location->getName() : "Unknown") << "\n";
         info << "   Ships: " << fleet->getShips().size() << "\n";
         info << "   Combat Strength: " << fleet->getCombatStrength() << "\n";
     }
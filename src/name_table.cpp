@@ -0,0 +1,90 @@
+#include "name_table.h"
+#include "bit_ops.h"
+
+#include <new>
+
+namespace {
+// FNV-1a.
+uint64_t nameHash(std::string_view s) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (const char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+} // namespace
+
+NameTable& NameTable::global() {
+    static NameTable table;
+    return table;
+}
+
+NameTable::~NameTable() {
+    const uint32_t n = count.load(std::memory_order_relaxed);
+    for (uint32_t id = 0; id < n; ++id) slot(id).~basic_string();
+    for (std::string* segment : segments) ::operator delete(segment);
+}
+
+std::string& NameTable::slot(NameId id) const {
+    const uint64_t block = (static_cast<uint64_t>(id) >> kFirstSegmentBits) + 1;
+    const int k = highestBit(block);
+    const uint64_t first = static_cast<uint64_t>(kFirstSegment) * ((uint64_t{1} << k) - 1);
+    return segments[static_cast<std::size_t>(k)][static_cast<std::size_t>(id - first)];
+}
+
+std::size_t NameTable::probe(std::string_view name, uint32_t hash) const {
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const uint64_t entry = slots[i];
+        if (entry == 0) return i;
+        if (static_cast<uint32_t>(entry >> 32) == hash && slot(static_cast<uint32_t>(entry) - 1) == name) return i;
+    }
+}
+
+void NameTable::grow() {
+    std::vector<uint64_t> old(slots.empty() ? 1024 : slots.size() * 2, 0);
+    old.swap(slots);
+    const std::size_t mask = slots.size() - 1;
+    for (const uint64_t entry : old) {
+        if (entry == 0) continue;
+        std::size_t i = static_cast<std::size_t>(entry >> 32) & mask;
+        while (slots[i] != 0) i = (i + 1) & mask;
+        slots[i] = entry;
+    }
+}
+
+NameId NameTable::intern(std::string_view name) {
+    const uint32_t hash = static_cast<uint32_t>(nameHash(name) >> 32);
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint32_t n = count.load(std::memory_order_relaxed);
+    // Keep the hash at most half full.
+    if ((static_cast<std::size_t>(n) + 1) * 2 > slots.size()) grow();
+    const std::size_t i = probe(name, hash);
+    if (slots[i] != 0) return static_cast<uint32_t>(slots[i]) - 1;
+    if (n == kNoName) return kNoName;
+
+    const uint64_t block = (static_cast<uint64_t>(n) >> kFirstSegmentBits) + 1;
+    const std::size_t k = static_cast<std::size_t>(highestBit(block));
+    if (!segments[k]) {
+        segments[k] = static_cast<std::string*>(::operator new((kFirstSegment << k) * sizeof(std::string)));
+    }
+    new (&slot(n)) std::string(name);
+    slots[i] = (static_cast<uint64_t>(hash) << 32) | (n + 1);
+    count.store(n + 1, std::memory_order_release);
+    return n;
+}
+
+NameId NameTable::find(std::string_view name) const {
+    const uint32_t hash = static_cast<uint32_t>(nameHash(name) >> 32);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slots.empty()) return kNoName;
+    const uint64_t entry = slots[probe(name, hash)];
+    return entry == 0 ? kNoName : static_cast<uint32_t>(entry) - 1;
+}
+
+const std::string& NameTable::get(NameId id) const {
+    static const std::string empty;
+    if (id == kNoName || id >= size()) return empty;
+    return slot(id);
+}
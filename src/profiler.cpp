@@ -0,0 +1,101 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Profiler::enabled{false};
+
+namespace {
+struct TraceEvent {
+    const char* name;
+    int64_t start;
+    int64_t end;
+};
+
+struct ThreadEvents {
+    uint32_t tid;
+    std::vector<TraceEvent> events;
+};
+
+// Buffers are owned here, not by their threads, so events from pool workers
+// that have since exited still make it into the trace.
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadEvents>> threads;
+};
+
+static TraceRegistry& registry() {
+    static TraceRegistry instance;
+    return instance;
+}
+
+static ThreadEvents& threadEvents() {
+    thread_local ThreadEvents* mine = nullptr;
+    if (!mine) {
+        TraceRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.threads.push_back(std::make_unique<ThreadEvents>());
+        mine = reg.threads.back().get();
+        mine->tid = static_cast<uint32_t>(reg.threads.size());
+    }
+    return *mine;
+}
+
+static void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+} // namespace
+
+void Profiler::record(const char* name, int64_t startNanos, int64_t endNanos) {
+    threadEvents().events.push_back(TraceEvent{name, startNanos, endNanos});
+}
+
+std::string Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return "Cannot write trace: failed to open file: " + path;
+    }
+
+    TraceRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // Timestamps are relative to the earliest event, in microseconds.
+    int64_t origin = INT64_MAX;
+    for (const auto& t : reg.threads) {
+        for (const auto& e : t->events) origin = std::min(origin, e.start);
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto& t : reg.threads) {
+        for (const auto& e : t->events) {
+            if (!first) out << ",\n";
+            first = false;
+            out << "{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"cat\":\"aurora\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t->tid
+                << ",\"ts\":" << static_cast<double>(e.start - origin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(e.end - e.start) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out.good()) return "Cannot write trace: write failed: " + path;
+    return {};
+}
+
+void Profiler::clear() {
+    TraceRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& t : reg.threads) t->events.clear();
+}
@@ -1,5 +1,6 @@
 #include "research.h"
 #include <algorithm>
+#include <queue>
 
 std::string techCategoryToString(TechCategory cat) {
     switch(cat) {
@@ -27,54 +28,130 @@ std::string techEraToString(TechEra era) {
     }
 }
 
-Technology::Technology(const std::string& id, const std::string& nm, TechCategory cat,
-                       TechEra er, int cst, const std::vector<std::string>& prereqs,
-                       const std::string& desc)
-    : techId(id), name(nm), category(cat), era(er), cost(cst),
-      prerequisites(prereqs), description(desc), researched(false), progress(0) {}
-
-void Technology::setProgressForLoad(int p) {
-        progress = std::max(0, p);
-        if (progress > cost) progress = cost;
+const TechCatalogue& TechCatalogue::standard() {
+    static const TechCatalogue catalogue;
+    return catalogue;
 }
 
-void Technology::setResearchedForLoad(bool v) {
-        researched = v;
-        if (researched) progress = cost;
+void TechCatalogue::addTech(const std::string& id, const std::string& name,
+                            TechCategory cat, TechEra era, int cost,
+                            const std::vector<std::string>& prereqs,
+                            const std::string& desc) {
+    defs.push_back(TechDefinition{id, name, cat, era, cost, prereqs, desc});
 }
 
-bool Technology::isAvailable(const std::set<std::string>& researchedTechs) const {
-    for (const auto& prereq : prerequisites) {
-        if (researchedTechs.find(prereq) == researchedTechs.end()) {
-            return false;
+void TechCatalogue::compile() {
+    // Id order keeps getAvailableTechs()/getAllTechs() in the same order as the
+    // old id-keyed map.
+    std::sort(defs.begin(), defs.end(),
+              [](const TechDefinition& a, const TechDefinition& b) { return a.id < b.id; });
+
+    indexById.clear();
+    indexById.reserve(defs.size());
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        indexById.emplace(defs[i].id, static_cast<TechIndex>(i));
+    }
+
+    prerequisiteMasks.assign(defs.size(), TechMask());
+    dependents.assign(defs.size(), {});
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        for (const auto& prereq : defs[i].prerequisites) {
+            auto it = indexById.find(prereq);
+            if (it == indexById.end()) {
+                // Unknown prerequisite: can never be met, so require an
+                // index that is never researched.
+                prerequisiteMasks[i] |= unknownPrerequisite();
+                continue;
+            }
+            prerequisiteMasks[i].set(it->second);
+            dependents[it->second].push_back(static_cast<TechIndex>(i));
         }
     }
-    return true;
+    compileAncestors();
 }
 
-bool Technology::addProgress(int points) {
-    if (researched) return true;
-    
-    progress += points;
-    if (progress >= cost) {
-        researched = true;
-        return true;
+void TechCatalogue::compileAncestors() {
+    // Kahn's algorithm; a min-heap on (cost, index) keeps the order stable and
+    // puts cheap techs first whenever there is a choice.
+    std::vector<int> pending(defs.size(), 0);
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        pending[i] = static_cast<int>((prerequisiteMasks[i] & ~unknownPrerequisite()).count());
+    }
+    auto later = [this](TechIndex a, TechIndex b) {
+        return defs[a].cost != defs[b].cost ? defs[a].cost > defs[b].cost : a > b;
+    };
+    std::priority_queue<TechIndex, std::vector<TechIndex>, decltype(later)> ready(later);
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        if (pending[i] == 0) ready.push(static_cast<TechIndex>(i));
+    }
+
+    topologicalOrder.clear();
+    topologicalOrder.reserve(defs.size());
+    ancestorMasks.assign(defs.size(), TechMask());
+    while (!ready.empty()) {
+        const TechIndex index = ready.top();
+        ready.pop();
+        topologicalOrder.push_back(index);
+        // All prerequisites are already ordered, so their closures are final.
+        TechMask closure = prerequisiteMasks[index];
+        for (std::size_t p = 0; p < defs.size(); ++p) {
+            if (prerequisiteMasks[index].test(p)) closure |= ancestorMasks[p];
+        }
+        ancestorMasks[index] = closure;
+        for (const TechIndex dep : dependents[index]) {
+            if (--pending[dep] == 0) ready.push(dep);
+        }
+    }
+    // A prerequisite cycle would leave techs unordered; they can never be
+    // researched, so mark them like an unknown prerequisite.
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+        if (pending[i] > 0) ancestorMasks[i] |= unknownPrerequisite();
     }
-    return false;
 }
 
-ResearchTree::ResearchTree() {
-    initializeTechTree();
+const TechIndex* TechCatalogue::findIndex(const std::string& techId) const {
+    auto it = indexById.find(techId);
+    return it != indexById.end() ? &it->second : nullptr;
 }
 
-void ResearchTree::addTech(const std::string& id, const std::string& name,
-                           TechCategory cat, TechEra era, int cost,
-                           const std::vector<std::string>& prereqs,
-                           const std::string& desc) {
-    technologies[id] = std::make_shared<Technology>(id, name, cat, era, cost, prereqs, desc);
+ResearchTree::ResearchTree()
+    : catalogue(&TechCatalogue::standard()), progress(catalogue->size(), 0) {
+    rebuildAvailable();
 }
 
-void ResearchTree::initializeTechTree() {
+void ResearchTree::rebuildAvailable() {
+    available.reset();
+    for (std::size_t i = 0; i < catalogue->size(); ++i) {
+        const TechIndex index = static_cast<TechIndex>(i);
+        if (!researched.test(index) && prerequisitesMet(index)) available.set(index);
+    }
+}
+
+void ResearchTree::markResearched(TechIndex index) {
+    researched.set(index);
+    available.reset(index);
+    // Only techs that list this one as a prerequisite can have become available.
+    for (const TechIndex dep : catalogue->dependentsOf(index)) {
+        if (!researched.test(dep) && prerequisitesMet(dep)) available.set(dep);
+    }
+
+    const int cost = catalogue->get(index).cost;
+    for (auto it = planCache.begin(); it != planCache.end();) {
+        ResearchPlan& plan = it->second;
+        if (plan.mask.test(index)) {
+            plan.steps.erase(std::find(plan.steps.begin(), plan.steps.end(), index));
+            plan.mask.reset(index);
+            plan.totalCost -= cost;
+        }
+        if (it->first == index) {
+            it = planCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+TechCatalogue::TechCatalogue() {
     // Pre-Warp Era
     addTech("basic_mining", "Basic Mining", TechCategory::MINING, TechEra::PRE_WARP,
             100, {}, "Unlocks basic mining facilities");
@@ -218,64 +295,97 @@ void ResearchTree::initializeTechTree() {
             7000, {"nanomaterials", "zero_point_energy"}, "Autonomous damage repair using embedded nanotech");
     addTech("omega_mining", "Omega Mining", TechCategory::MINING, TechEra::FUTURE,
             6000, {"deep_core_mining", "zero_point_energy"}, "Ultra-efficient extraction using exotic energy sources");
+
+    compile();
 }
 
-std::vector<std::shared_ptr<Technology>> ResearchTree::getAvailableTechs() const {
-    std::vector<std::shared_ptr<Technology>> available;
-    for (const auto& pair : technologies) {
-        auto tech = pair.second;
-        if (!tech->isResearched() && tech->isAvailable(researched)) {
-            available.push_back(tech);
-        }
+std::vector<Technology> ResearchTree::getAvailableTechs() const {
+    std::vector<Technology> result;
+    result.reserve(available.count());
+    for (std::size_t i = 0; i < catalogue->size(); ++i) {
+        if (available.test(i)) result.emplace_back(*this, static_cast<TechIndex>(i));
     }
-    return available;
+    return result;
 }
 
-std::vector<std::shared_ptr<Technology>> ResearchTree::getAllTechs() const {
-        std::vector<std::shared_ptr<Technology>> all;
-        all.reserve(technologies.size());
-        for (const auto& pair : technologies) {
-                all.push_back(pair.second);
-        }
-        return all;
+std::vector<Technology> ResearchTree::getAllTechs() const {
+    std::vector<Technology> result;
+    result.reserve(catalogue->size());
+    for (std::size_t i = 0; i < catalogue->size(); ++i) {
+        result.emplace_back(*this, static_cast<TechIndex>(i));
+    }
+    return result;
 }
 
 bool ResearchTree::research(const std::string& techId, int points) {
-    auto it = technologies.find(techId);
-    if (it == technologies.end()) return false;
-    
-    auto tech = it->second;
-    if (!tech->isAvailable(researched)) return false;
-    
-    bool completed = tech->addProgress(points);
-    if (completed) {
-        researched.insert(techId);
-    }
-    return completed;
+    const TechIndex* index = catalogue->findIndex(techId);
+    if (!index) return false;
+    if (!prerequisitesMet(*index)) return false;
+    if (researched.test(*index)) return true;
+
+    int& p = progress[*index];
+    p += points;
+    if (p < catalogue->get(*index).cost) return false;
+    markResearched(*index);
+    return true;
+}
+
+std::optional<Technology> ResearchTree::getTech(const std::string& techId) const {
+    const TechIndex* index = catalogue->findIndex(techId);
+    if (!index) return std::nullopt;
+    return Technology(*this, *index);
+}
+
+const ResearchPlan* ResearchTree::planPathTo(const std::string& techId) const {
+    const TechIndex* index = catalogue->findIndex(techId);
+    return index ? planPathTo(*index) : nullptr;
 }
 
-std::shared_ptr<Technology> ResearchTree::getTech(const std::string& techId) const {
-    auto it = technologies.find(techId);
-    return (it != technologies.end()) ? it->second : nullptr;
+const ResearchPlan* ResearchTree::planPathTo(TechIndex target) const {
+    if (target >= catalogue->size()) return nullptr;
+    auto cached = planCache.find(target);
+    if (cached != planCache.end()) return &cached->second;
+
+    TechMask needed = catalogue->ancestors(target);
+    needed.set(target);
+    needed &= ~researched;
+    if ((needed & TechCatalogue::unknownPrerequisite()).any()) return nullptr;
+
+    ResearchPlan plan;
+    plan.mask = needed;
+    plan.steps.reserve(needed.count());
+    for (const TechIndex index : catalogue->topologicalOrderOf()) {
+        if (!needed.test(index)) continue;
+        plan.steps.push_back(index);
+        plan.totalCost += catalogue->get(index).cost;
+    }
+    return &planCache.emplace(target, std::move(plan)).first->second;
 }
 
 bool ResearchTree::isResearched(const std::string& techId) const {
-    return researched.find(techId) != researched.end();
+    const TechIndex* index = catalogue->findIndex(techId);
+    return index && researched.test(*index);
 }
 
-void ResearchTree::setTechStateForLoad(const std::string& techId, int progress, bool researchedFlag) {
-        auto it = technologies.find(techId);
-        if (it == technologies.end()) return;
+bool ResearchTree::isAvailable(const std::string& techId) const {
+    const TechIndex* index = catalogue->findIndex(techId);
+    return index && available.test(*index);
+}
 
-        auto tech = it->second;
-        if (!tech) return;
+void ResearchTree::setTechStateForLoad(const std::string& techId, int p, bool researchedFlag) {
+        const TechIndex* index = catalogue->findIndex(techId);
+        if (!index) return;
 
-        tech->setProgressForLoad(progress);
-        tech->setResearchedForLoad(researchedFlag);
+        const int cost = catalogue->get(*index).cost;
+        progress[*index] = researchedFlag ? cost : std::min(std::max(0, p), cost);
 
         if (researchedFlag) {
-                researched.insert(techId);
-        } else {
-                researched.erase(techId);
+                markResearched(*index);
+        } else if (researched.test(*index)) {
+                // Un-researching can take availability away from dependents;
+                // rare enough (loading only) to recompute everything.
+                researched.reset(*index);
+                rebuildAvailable();
+                planCache.clear();
         }
 }
@@ -1,7 +1,7 @@
 #include "resources.h"
+#include "name_index.h"
 
 #include <algorithm>
-#include <cctype>
 
 std::string resourceTypeToString(ResourceType type) {
     switch(type) {
@@ -24,28 +24,22 @@ std::string resourceTypeToString(ResourceType type) {
     }
 }
 
-static std::string toLower(std::string s) {
-    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return s;
-}
-
-bool resourceTypeFromString(const std::string& s, ResourceType& out) {
-    const std::string v = toLower(s);
-    if (v == "minerals") { out = ResourceType::MINERALS; return true; }
-    if (v == "energy") { out = ResourceType::ENERGY; return true; }
-    if (v == "population") { out = ResourceType::POPULATION; return true; }
-    if (v == "research points" || v == "research_points" || v == "rp" || v == "research") { out = ResourceType::RESEARCH_POINTS; return true; }
-    if (v == "fuel") { out = ResourceType::FUEL; return true; }
-    if (v == "duranium") { out = ResourceType::DURANIUM; return true; }
-    if (v == "neutronium") { out = ResourceType::NEUTRONIUM; return true; }
-    if (v == "corundium") { out = ResourceType::CORUNDIUM; return true; }
-    if (v == "tritanium") { out = ResourceType::TRITANIUM; return true; }
-    if (v == "boronide") { out = ResourceType::BORONIDE; return true; }
-    if (v == "mercassium") { out = ResourceType::MERCASSIUM; return true; }
-    if (v == "vendarite") { out = ResourceType::VENDARITE; return true; }
-    if (v == "sorium") { out = ResourceType::SORIUM; return true; }
-    if (v == "uridium") { out = ResourceType::URIDIUM; return true; }
-    if (v == "gallicite") { out = ResourceType::GALLICITE; return true; }
+bool resourceTypeFromString(std::string_view s, ResourceType& out) {
+    if (foldedNamesEqual(s, "minerals")) { out = ResourceType::MINERALS; return true; }
+    if (foldedNamesEqual(s, "energy")) { out = ResourceType::ENERGY; return true; }
+    if (foldedNamesEqual(s, "population")) { out = ResourceType::POPULATION; return true; }
+    if (foldedNamesEqual(s, "research points") || foldedNamesEqual(s, "research_points") || foldedNamesEqual(s, "rp") || foldedNamesEqual(s, "research")) { out = ResourceType::RESEARCH_POINTS; return true; }
+    if (foldedNamesEqual(s, "fuel")) { out = ResourceType::FUEL; return true; }
+    if (foldedNamesEqual(s, "duranium")) { out = ResourceType::DURANIUM; return true; }
+    if (foldedNamesEqual(s, "neutronium")) { out = ResourceType::NEUTRONIUM; return true; }
+    if (foldedNamesEqual(s, "corundium")) { out = ResourceType::CORUNDIUM; return true; }
+    if (foldedNamesEqual(s, "tritanium")) { out = ResourceType::TRITANIUM; return true; }
+    if (foldedNamesEqual(s, "boronide")) { out = ResourceType::BORONIDE; return true; }
+    if (foldedNamesEqual(s, "mercassium")) { out = ResourceType::MERCASSIUM; return true; }
+    if (foldedNamesEqual(s, "vendarite")) { out = ResourceType::VENDARITE; return true; }
+    if (foldedNamesEqual(s, "sorium")) { out = ResourceType::SORIUM; return true; }
+    if (foldedNamesEqual(s, "uridium")) { out = ResourceType::URIDIUM; return true; }
+    if (foldedNamesEqual(s, "gallicite")) { out = ResourceType::GALLICITE; return true; }
     return false;
 }
 
@@ -72,8 +66,7 @@ ResourceStorage::ResourceStorage() {
 }
 
 int ResourceStorage::get(ResourceType type) const {
-    auto it = resources.find(type);
-    return (it != resources.end()) ? it->second : 0;
+    return resources[type];
 }
 
 void ResourceStorage::add(ResourceType type, int amount) {
@@ -93,27 +86,18 @@ bool ResourceStorage::consume(ResourceType type, int amount) {
 }
 
 void ResourceStorage::produce(int turns) {
-    for (const auto& pair : productionRates) {
-        add(pair.first, pair.second * turns);
-    }
+    resources.addScaled(productionRates, turns);
 }
 
-bool ResourceStorage::canAfford(const std::map<ResourceType, int>& costs) const {
-    for (const auto& cost : costs) {
-        if (get(cost.first) < cost.second) {
-            return false;
-        }
-    }
-    return true;
+bool ResourceStorage::canAfford(const ResourceAmounts& costs) const {
+    return resources.covers(costs);
 }
 
-bool ResourceStorage::payCosts(const std::map<ResourceType, int>& costs) {
+bool ResourceStorage::payCosts(const ResourceAmounts& costs) {
     if (!canAfford(costs)) {
         return false;
     }
-    for (const auto& cost : costs) {
-        consume(cost.first, cost.second);
-    }
+    resources -= costs;
     return true;
 }
 
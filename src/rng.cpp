@@ -0,0 +1,34 @@
+#include "rng.h"
+#include "name_index.h"
+
+std::string rngStreamToString(RngStreamId id) {
+    switch(id) {
+        case RngStreamId::COMBAT: return "combat";
+        case RngStreamId::AI_TURN: return "ai_turn";
+        case RngStreamId::PREDICTION: return "prediction";
+        default: return "unknown";
+    }
+}
+
+bool rngStreamFromString(std::string_view s, RngStreamId& out) {
+    if (foldedNamesEqual(s, "combat")) { out = RngStreamId::COMBAT; return true; }
+    if (foldedNamesEqual(s, "ai_turn")) { out = RngStreamId::AI_TURN; return true; }
+    if (foldedNamesEqual(s, "prediction")) { out = RngStreamId::PREDICTION; return true; }
+    return false;
+}
+
+RngService::RngService(uint64_t seed) : seed(seed) {
+    reseed(seed);
+}
+
+void RngService::reseed(uint64_t newSeed) {
+    seed = newSeed;
+    for (std::size_t i = 0; i < streams.size(); ++i) {
+        streams[i] = RandomStream(rngDeriveKey(seed, i), 0);
+    }
+}
+
+RandomStream RngService::fork(RngStreamId id, uint64_t index) const {
+    // Offset the first index so forks never collide with the subsystem streams.
+    return RandomStream(rngDeriveKey(seed, static_cast<uint64_t>(id) + 0x100, index), 0);
+}
@@ -0,0 +1,902 @@
+#include "save_game.h"
+
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// ---- V1 text format --------------------------------------------------------
+
+static bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Accepts exactly what std::stoi accepts on trimmed text: an optional sign
+// followed by decimal digits, within int range.
+static bool parseInt(std::string_view s, int& out) {
+    bool negative = false;
+    if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
+        negative = s[0] == '-';
+        s.remove_prefix(1);
+    }
+    if (s.empty()) return false;
+    long long v = 0;
+    for (const char c : s) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+        if (v > static_cast<long long>(INT_MAX) + 1) return false;
+    }
+    if (negative) v = -v;
+    if (v > INT_MAX || v < INT_MIN) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+static bool parseUInt64(std::string_view s, uint64_t& out) {
+    if (!s.empty() && s[0] == '+') s.remove_prefix(1);
+    if (s.empty()) return false;
+    uint64_t v = 0;
+    for (const char c : s) {
+        if (c < '0' || c > '9') return false;
+        const uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (v > (UINT64_MAX - digit) / 10) return false;
+        v = v * 10 + digit;
+    }
+    out = v;
+    return true;
+}
+
+// Returns the text before the first `delim` and advances `s` past it; takes
+// the whole remainder when there is no delimiter.
+static std::string_view cutField(std::string_view& s, char delim) {
+    const std::size_t pos = s.find(delim);
+    const std::string_view field = s.substr(0, pos);
+    s.remove_prefix(pos == std::string_view::npos ? s.size() : pos + 1);
+    return field;
+}
+
+// Splits "key<delim>value" (exactly one delimiter) into trimmed halves.
+static bool splitPair(std::string_view s, char delim, std::string_view& key, std::string_view& value) {
+    const std::size_t pos = s.find(delim);
+    if (pos == std::string_view::npos || s.find(delim, pos + 1) != std::string_view::npos) return false;
+    key = trim(s.substr(0, pos));
+    value = trim(s.substr(pos + 1));
+    return true;
+}
+
+// Reads a file front to back in large blocks and hands out one line at a
+// time as a view into the block buffer, valid until the next call.
+class LineReader {
+private:
+    std::ifstream in;
+    std::vector<char> buffer;
+    std::size_t begin;
+    std::size_t end;
+    bool eof;
+
+public:
+    explicit LineReader(const std::string& path, std::size_t blockSize = 1 << 20)
+        : in(path, std::ios::in | std::ios::binary), buffer(blockSize), begin(0), end(0), eof(false) {}
+
+    bool isOpen() const { return in.is_open(); }
+
+    bool next(std::string_view& line) {
+        for (;;) {
+            const char* start = buffer.data() + begin;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+            if (newline) {
+                line = std::string_view(start, static_cast<std::size_t>(newline - start));
+                begin += line.size() + 1;
+                return true;
+            }
+            if (eof) {
+                if (begin == end) return false;
+                line = std::string_view(start, end - begin);
+                begin = end;
+                return true;
+            }
+
+            // Keep the partial line, then refill behind it.
+            std::memmove(buffer.data(), start, end - begin);
+            end -= begin;
+            begin = 0;
+            if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+            in.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+            const std::streamsize got = in.gcount();
+            if (got <= 0) {
+                eof = true;
+            } else {
+                end += static_cast<std::size_t>(got);
+            }
+        }
+    }
+};
+
+static std::string serializeResources(const std::vector<std::pair<ResourceType, int>>& resources) {
+    // Comma-separated key:value pairs.
+    std::ostringstream oss;
+    bool first = true;
+    for (const auto& kv : resources) {
+        if (!first) oss << ",";
+        first = false;
+        oss << resourceTypeToString(kv.first) << ":" << kv.second;
+    }
+    return oss.str();
+}
+
+static void parseResources(std::string_view encoded, std::vector<std::pair<ResourceType, int>>& out) {
+    while (!encoded.empty()) {
+        std::string_view name, amountText;
+        if (!splitPair(cutField(encoded, ','), ':', name, amountText)) continue;
+        ResourceType t;
+        int amount = 0;
+        if (!resourceTypeFromString(name, t)) continue;
+        if (!parseInt(amountText, amount)) continue;
+        out.emplace_back(t, amount);
+    }
+}
+
+static NameId internField(std::string_view value) {
+    return value.empty() ? kNoName : internName(value);
+}
+
+static void writeTextEmpireBody(std::ostream& out, const SavedEmpire& e) {
+    for (const auto& t : e.techs) {
+        out << "tech=" << t.id << "," << t.progress << "," << (t.researched ? 1 : 0) << "\n";
+    }
+}
+
+static void writeTextColonies(std::ostream& out, const SavedEmpire& e) {
+    for (const auto& c : e.colonies) {
+        out << "colony=" << nameOf(c.name)
+            << ";system=" << nameOf(c.system)
+            << ";planet=" << nameOf(c.planet)
+            << ";pop=" << c.pop
+            << ";mines=" << c.mines
+            << ";factories=" << c.factories << "\n";
+    }
+}
+
+static void writeTextFleets(std::ostream& out, const SavedEmpire& e) {
+    for (const auto& f : e.fleets) {
+        out << "fleet=" << nameOf(f.name) << ";system=" << nameOf(f.system) << "\n";
+        for (const auto& ship : f.ships) {
+            out << "ship=" << nameOf(ship.name)
+                << ";class=" << shipClassToString(ship.cls)
+                << ";hull=" << ship.hull
+                << ";shields=" << ship.shields << "\n";
+        }
+        out << "endfleet\n";
+    }
+}
+
+static std::string writeTextSave(const SaveData& data, const std::string& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return "Cannot save: failed to open file: " + path;
+    }
+
+    out << "AURORA_SAVE_V1\n";
+    out << "seed=" << data.seed << "\n";
+    out << "numSystems=" << data.numSystems << "\n";
+    out << "galaxyGenerator=" << static_cast<uint32_t>(data.galaxyGenerator) << "\n";
+    if (data.haveRngState) {
+        out << "rngSeed=" << data.rngSeed << "\n";
+        for (const auto& rc : data.rngCounters) {
+            out << "rngStream=" << rngStreamToString(rc.first) << "," << rc.second << "\n";
+        }
+    }
+
+    out << "[Player]\n";
+    out << "name=" << data.player.name << "\n";
+    out << "turn=" << data.player.turn << "\n";
+    out << "currentResearch=" << data.player.currentResearch << "\n";
+    out << "resources=" << serializeResources(data.player.resources) << "\n";
+    writeTextEmpireBody(out, data.player);
+
+    out << "[Explored]\n";
+    for (const NameId name : data.exploredSystems) {
+        out << "system=" << nameOf(name) << "\n";
+    }
+
+    out << "[Colonies]\n";
+    writeTextColonies(out, data.player);
+
+    out << "[Fleets]\n";
+    writeTextFleets(out, data.player);
+
+    out << "[Hostiles]\n";
+    for (const auto& h : data.hostiles) {
+        out << "[Hostile]\n";
+        out << "name=" << h.e.name << "\n";
+        out << "contacted=" << (h.contacted ? 1 : 0) << "\n";
+        out << "atWar=" << (h.atWar ? 1 : 0) << "\n";
+        out << "turn=" << h.e.turn << "\n";
+        out << "currentResearch=" << h.e.currentResearch << "\n";
+        out << "resources=" << serializeResources(h.e.resources) << "\n";
+        writeTextEmpireBody(out, h.e);
+        writeTextColonies(out, h.e);
+        writeTextFleets(out, h.e);
+        out << "endhostile\n";
+    }
+
+    if (!out.good()) return "Cannot save: write failed: " + path;
+    return {};
+}
+
+// False for generators this build does not know.
+static bool galaxyGeneratorFromInt(int value, GalaxyGenerator& out) {
+    if (value == static_cast<int>(GalaxyGenerator::SEQUENTIAL_MT19937)) {
+        out = GalaxyGenerator::SEQUENTIAL_MT19937;
+    } else if (value == static_cast<int>(GalaxyGenerator::COUNTER_STREAMS)) {
+        out = GalaxyGenerator::COUNTER_STREAMS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Single pass over the file with no per-line or per-token copies; the only
+// allocations are the names and vectors that end up in SaveData.
+static std::string readTextSave(const std::string& path, SaveData& data) {
+    LineReader reader(path);
+    if (!reader.isOpen()) {
+        return "Cannot load: failed to open file: " + path;
+    }
+
+    std::string_view line;
+    if (!reader.next(line) || trim(line) != "AURORA_SAVE_V1") {
+        return "Cannot load: invalid save header";
+    }
+
+    enum class Section { None, Player, Explored, Colonies, Fleets, Hostiles, Hostile };
+    Section section = Section::None;
+    SavedHostile* curHostile = nullptr;
+    SavedFleet* curFleet = nullptr;
+
+    while (reader.next(line)) {
+        line = trim(line);
+        if (line.empty()) continue;
+        if (line[0] == '#') continue;
+
+        if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
+            const std::string_view tag = line.substr(1, line.size() - 2);
+            if (tag == "Player") { section = Section::Player; curHostile = nullptr; curFleet = nullptr; }
+            else if (tag == "Explored") { section = Section::Explored; curHostile = nullptr; curFleet = nullptr; }
+            else if (tag == "Colonies") { section = Section::Colonies; curHostile = nullptr; curFleet = nullptr; }
+            else if (tag == "Fleets") { section = Section::Fleets; curHostile = nullptr; curFleet = nullptr; }
+            else if (tag == "Hostiles") { section = Section::Hostiles; curHostile = nullptr; curFleet = nullptr; }
+            else if (tag == "Hostile") {
+                section = Section::Hostile;
+                data.hostiles.push_back(SavedHostile{});
+                curHostile = &data.hostiles.back();
+                curFleet = nullptr;
+            }
+            continue;
+        }
+
+        const std::size_t eq = line.find('=');
+        if (eq == std::string_view::npos) {
+            if (line == "endfleet") {
+                curFleet = nullptr;
+                continue;
+            }
+            if (line == "endhostile") {
+                curHostile = nullptr;
+                section = Section::Hostiles;
+                curFleet = nullptr;
+                continue;
+            }
+            continue;
+        }
+
+        const std::string_view key = trim(line.substr(0, eq));
+        const std::string_view value = trim(line.substr(eq + 1));
+
+        if (section == Section::None) {
+            if (key == "seed") {
+                uint64_t tmp = 0;
+                if (parseUInt64(value, tmp)) data.seed = static_cast<uint32_t>(tmp);
+            } else if (key == "numSystems") {
+                int tmp = 0;
+                if (parseInt(value, tmp)) data.numSystems = tmp;
+            } else if (key == "galaxyGenerator") {
+                int tmp = 0;
+                if (!parseInt(value, tmp) || !galaxyGeneratorFromInt(tmp, data.galaxyGenerator)) {
+                    return "Cannot load: unsupported galaxy generator";
+                }
+            } else if (key == "rngSeed") {
+                data.haveRngState = parseUInt64(value, data.rngSeed);
+            } else if (key == "rngStream") {
+                std::string_view name, counterText;
+                RngStreamId id;
+                uint64_t counter = 0;
+                if (splitPair(value, ',', name, counterText) && rngStreamFromString(name, id) &&
+                    parseUInt64(counterText, counter)) {
+                    data.rngCounters.emplace_back(id, counter);
+                }
+            }
+            continue;
+        }
+
+        if (section == Section::Explored) {
+            if (key == "system") data.exploredSystems.push_back(internField(value));
+            continue;
+        }
+
+        if (section == Section::Player || section == Section::Hostile || section == Section::Colonies || section == Section::Fleets) {
+            SavedEmpire* ePtr = nullptr;
+            if (section == Section::Hostile && curHostile) {
+                ePtr = &curHostile->e;
+            } else {
+                // Player sections (including legacy [Colonies]/[Fleets])
+                ePtr = &data.player;
+            }
+
+            auto& e = *ePtr;
+            if (key == "name") e.name = value;
+            else if (key == "turn") { int t = 0; if (parseInt(value, t)) e.turn = t; }
+            else if (key == "currentResearch") e.currentResearch = value;
+            else if (key == "resources") parseResources(value, e.resources);
+            else if (key == "contacted" && curHostile) { int v = 0; if (parseInt(value, v)) curHostile->contacted = (v != 0); }
+            else if (key == "atWar" && curHostile) { int v = 0; if (parseInt(value, v)) curHostile->atWar = (v != 0); }
+            else if (key == "tech") {
+                // id,progress,researched[,...]
+                const std::size_t firstComma = value.find(',');
+                if (firstComma != std::string_view::npos && value.find(',', firstComma + 1) != std::string_view::npos) {
+                    std::string_view rest = value;
+                    SavedTech& t = e.techs.emplace_back();
+                    t.id = trim(cutField(rest, ','));
+                    parseInt(trim(cutField(rest, ',')), t.progress);
+                    int rf = 0;
+                    parseInt(trim(cutField(rest, ',')), rf);
+                    t.researched = (rf != 0);
+                }
+            } else if (key == "colony") {
+                // Semicolon-delimited k=v pairs with the first token being the name.
+                std::string_view rest = value;
+                SavedColony& c = e.colonies.emplace_back();
+                c.name = internField(trim(cutField(rest, ';')));
+                while (!rest.empty()) {
+                    std::string_view k2, v2;
+                    if (!splitPair(cutField(rest, ';'), '=', k2, v2)) continue;
+                    if (k2 == "system") c.system = internField(v2);
+                    else if (k2 == "planet") c.planet = internField(v2);
+                    else if (k2 == "pop") parseInt(v2, c.pop);
+                    else if (k2 == "mines") parseInt(v2, c.mines);
+                    else if (k2 == "factories") parseInt(v2, c.factories);
+                }
+            } else if (key == "fleet") {
+                std::string_view rest = value;
+                SavedFleet& f = e.fleets.emplace_back();
+                f.name = internField(trim(cutField(rest, ';')));
+                while (!rest.empty()) {
+                    std::string_view k2, v2;
+                    if (!splitPair(cutField(rest, ';'), '=', k2, v2)) continue;
+                    if (k2 == "system") f.system = internField(v2);
+                }
+                curFleet = &f;
+            } else if (key == "ship" && curFleet) {
+                std::string_view rest = value;
+                SavedShip& sship = curFleet->ships.emplace_back();
+                sship.name = internField(trim(cutField(rest, ';')));
+                while (!rest.empty()) {
+                    std::string_view k2, v2;
+                    if (!splitPair(cutField(rest, ';'), '=', k2, v2)) continue;
+                    if (k2 == "class") {
+                        ShipClass sc;
+                        if (shipClassFromString(v2, sc)) sship.cls = sc;
+                    } else if (k2 == "hull") {
+                        parseInt(v2, sship.hull);
+                    } else if (k2 == "shields") {
+                        parseInt(v2, sship.shields);
+                    }
+                }
+            }
+            continue;
+        }
+    }
+
+    return {};
+}
+
+// ---- V2 binary format ------------------------------------------------------
+//
+// All integers are little-endian. The file is a fixed header followed by
+// sections of fixed-width records; every string is a (offset, length) reference
+// into a single string-data section, so records never need parsing.
+//
+//   header   magic[16] version u32 seed u32 numSystems u32 flags u32
+//            rngSeed u64 then {offset u32, count u32} per section
+//   EMPIRE   name ref, currentResearch ref, turn, flags, resourceMask,
+//            resources[kResourceTypeCount], techFirst/Count,
+//            colonyFirst/Count, fleetFirst/Count (empire 0 is the player)
+//   TECH     id ref, progress, researched
+//   COLONY   name ref, system ref, planet ref, pop, mines, factories
+//   FLEET    name ref, system ref, shipFirst/Count
+//   SHIP     name ref, class, hull, shields
+//   EXPLORED system ref
+//   RNG      stream id, reserved, counter u64
+//   STRINGS  raw bytes (count = byte length)
+
+const char kBinaryMagic[16] = {'A', 'U', 'R', 'O', 'R', 'A', '_', 'S', 'A', 'V', 'E', '_', 'V', '2', 0, 0};
+constexpr uint32_t kBinaryVersion = 2;
+constexpr uint32_t kFlagHaveRngState = 1u << 0;
+// Clear in saves from before the galaxy generator was recorded.
+constexpr uint32_t kFlagCounterStreamGalaxy = 1u << 1;
+constexpr uint32_t kEmpirePlayer = 1u << 0;
+constexpr uint32_t kEmpireContacted = 1u << 1;
+constexpr uint32_t kEmpireAtWar = 1u << 2;
+
+enum BinarySection : uint32_t { EMPIRES, TECHS, COLONIES, FLEETS, SHIPS, EXPLORED, RNG, STRINGS, SECTION_COUNT };
+
+constexpr std::size_t kHeaderSize = 16 + 4 * 4 + 8 + SECTION_COUNT * 8;
+constexpr std::size_t kRecordSize[SECTION_COUNT] = {
+    4 * (2 + 2 + 3 + kResourceTypeCount + 6), // EMPIRES
+    4 * (2 + 2),                              // TECHS
+    4 * (2 + 2 + 2 + 3),                      // COLONIES
+    4 * (2 + 2 + 2),                          // FLEETS
+    4 * (2 + 3),                              // SHIPS
+    4 * 2,                                    // EXPLORED
+    4 * 2 + 8,                                // RNG
+    1                                         // STRINGS
+};
+
+class BinaryWriter {
+private:
+    std::vector<char> section[SECTION_COUNT];
+    uint32_t count[SECTION_COUNT] = {};
+    std::unordered_map<std::string, uint32_t> interned;
+    std::unordered_map<NameId, uint32_t> internedNames;
+
+public:
+    void put32(BinarySection s, uint32_t v) {
+        for (int i = 0; i < 4; ++i) section[s].push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+    void putInt(BinarySection s, int v) { put32(s, static_cast<uint32_t>(v)); }
+    void put64(BinarySection s, uint64_t v) {
+        put32(s, static_cast<uint32_t>(v));
+        put32(s, static_cast<uint32_t>(v >> 32));
+    }
+    void putString(BinarySection s, const std::string& str) {
+        // Identical strings (system names in particular) share one copy.
+        auto it = interned.find(str);
+        if (it == interned.end()) {
+            it = interned.emplace(str, static_cast<uint32_t>(section[STRINGS].size())).first;
+            section[STRINGS].insert(section[STRINGS].end(), str.begin(), str.end());
+        }
+        put32(s, it->second);
+        put32(s, static_cast<uint32_t>(str.size()));
+    }
+    // Hashes each distinct name's text once; repeats are an integer lookup.
+    void putName(BinarySection s, NameId name) {
+        const std::string& str = nameOf(name);
+        auto it = internedNames.find(name);
+        if (it == internedNames.end()) {
+            putString(s, str);
+            internedNames.emplace(name, interned.find(str)->second);
+            return;
+        }
+        put32(s, it->second);
+        put32(s, static_cast<uint32_t>(str.size()));
+    }
+    uint32_t nextIndex(BinarySection s) const { return count[s]; }
+    void endRecord(BinarySection s) { count[s]++; }
+
+    std::vector<char> finish(const SaveData& data) {
+        count[STRINGS] = static_cast<uint32_t>(section[STRINGS].size());
+        std::vector<char> out;
+        std::size_t total = kHeaderSize;
+        for (uint32_t s = 0; s < SECTION_COUNT; ++s) total += section[s].size();
+        out.reserve(total);
+
+        auto put32Out = [&out](uint32_t v) {
+            for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        };
+        out.insert(out.end(), kBinaryMagic, kBinaryMagic + 16);
+        put32Out(kBinaryVersion);
+        put32Out(data.seed);
+        put32Out(static_cast<uint32_t>(data.numSystems));
+        put32Out((data.haveRngState ? kFlagHaveRngState : 0u) |
+                 (data.galaxyGenerator == GalaxyGenerator::COUNTER_STREAMS ? kFlagCounterStreamGalaxy : 0u));
+        put32Out(static_cast<uint32_t>(data.rngSeed));
+        put32Out(static_cast<uint32_t>(data.rngSeed >> 32));
+        uint32_t offset = static_cast<uint32_t>(kHeaderSize);
+        for (uint32_t s = 0; s < SECTION_COUNT; ++s) {
+            put32Out(offset);
+            put32Out(count[s]);
+            offset += static_cast<uint32_t>(section[s].size());
+        }
+        for (uint32_t s = 0; s < SECTION_COUNT; ++s) out.insert(out.end(), section[s].begin(), section[s].end());
+        return out;
+    }
+};
+
+static void writeBinaryEmpire(BinaryWriter& w, const SavedEmpire& e, uint32_t flags) {
+    const uint32_t techFirst = w.nextIndex(TECHS);
+    for (const auto& t : e.techs) {
+        w.putString(TECHS, t.id);
+        w.putInt(TECHS, t.progress);
+        w.put32(TECHS, t.researched ? 1u : 0u);
+        w.endRecord(TECHS);
+    }
+
+    const uint32_t colonyFirst = w.nextIndex(COLONIES);
+    for (const auto& c : e.colonies) {
+        w.putName(COLONIES, c.name);
+        w.putName(COLONIES, c.system);
+        w.putName(COLONIES, c.planet);
+        w.putInt(COLONIES, c.pop);
+        w.putInt(COLONIES, c.mines);
+        w.putInt(COLONIES, c.factories);
+        w.endRecord(COLONIES);
+    }
+
+    const uint32_t fleetFirst = w.nextIndex(FLEETS);
+    for (const auto& f : e.fleets) {
+        const uint32_t shipFirst = w.nextIndex(SHIPS);
+        for (const auto& sh : f.ships) {
+            w.putName(SHIPS, sh.name);
+            w.put32(SHIPS, static_cast<uint32_t>(sh.cls));
+            w.putInt(SHIPS, sh.hull);
+            w.putInt(SHIPS, sh.shields);
+            w.endRecord(SHIPS);
+        }
+        w.putName(FLEETS, f.name);
+        w.putName(FLEETS, f.system);
+        w.put32(FLEETS, shipFirst);
+        w.put32(FLEETS, static_cast<uint32_t>(f.ships.size()));
+        w.endRecord(FLEETS);
+    }
+
+    int amounts[kResourceTypeCount] = {};
+    uint32_t mask = 0;
+    for (const auto& r : e.resources) {
+        const std::size_t idx = static_cast<std::size_t>(r.first);
+        if (idx >= kResourceTypeCount) continue;
+        amounts[idx] = r.second;
+        mask |= 1u << idx;
+    }
+
+    w.putString(EMPIRES, e.name);
+    w.putString(EMPIRES, e.currentResearch);
+    w.putInt(EMPIRES, e.turn);
+    w.put32(EMPIRES, flags);
+    w.put32(EMPIRES, mask);
+    for (std::size_t i = 0; i < kResourceTypeCount; ++i) w.putInt(EMPIRES, amounts[i]);
+    w.put32(EMPIRES, techFirst);
+    w.put32(EMPIRES, static_cast<uint32_t>(e.techs.size()));
+    w.put32(EMPIRES, colonyFirst);
+    w.put32(EMPIRES, static_cast<uint32_t>(e.colonies.size()));
+    w.put32(EMPIRES, fleetFirst);
+    w.put32(EMPIRES, static_cast<uint32_t>(e.fleets.size()));
+    w.endRecord(EMPIRES);
+}
+
+static std::string writeBinarySave(const SaveData& data, const std::string& path) {
+    BinaryWriter w;
+    writeBinaryEmpire(w, data.player, kEmpirePlayer);
+    for (const auto& h : data.hostiles) {
+        writeBinaryEmpire(w, h.e, (h.contacted ? kEmpireContacted : 0u) | (h.atWar ? kEmpireAtWar : 0u));
+    }
+    for (const NameId name : data.exploredSystems) {
+        w.putName(EXPLORED, name);
+        w.endRecord(EXPLORED);
+    }
+    if (data.haveRngState) {
+        for (const auto& rc : data.rngCounters) {
+            w.put32(RNG, static_cast<uint32_t>(rc.first));
+            w.put32(RNG, 0);
+            w.put64(RNG, rc.second);
+            w.endRecord(RNG);
+        }
+    }
+
+    const std::vector<char> bytes = w.finish(data);
+    std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out.is_open()) {
+        return "Cannot save: failed to open file: " + path;
+    }
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out.good()) return "Cannot save: write failed: " + path;
+    return {};
+}
+
+// Read-only view of a whole file, memory-mapped where the platform allows.
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (bytes) length = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                bytes = static_cast<const char*>(p);
+                length = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        // The mapping stays valid after the descriptor is closed.
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+};
+
+static uint32_t load32(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(u[0]) | (static_cast<uint32_t>(u[1]) << 8) |
+           (static_cast<uint32_t>(u[2]) << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+static uint64_t load64(const char* p) {
+    return static_cast<uint64_t>(load32(p)) | (static_cast<uint64_t>(load32(p + 4)) << 32);
+}
+
+// Walks the sections of a mapped V2 image. Every offset and string reference
+// is bounds-checked once against the mapping; records are decoded in place.
+class BinaryReader {
+private:
+    const char* base;
+    std::size_t length;
+    const char* sectionStart[SECTION_COUNT] = {};
+    uint32_t sectionCount[SECTION_COUNT] = {};
+
+public:
+    BinaryReader(const char* base, std::size_t length) : base(base), length(length) {}
+
+    bool open() {
+        if (length < kHeaderSize) return false;
+        const char* table = base + 16 + 4 * 4 + 8;
+        for (uint32_t s = 0; s < SECTION_COUNT; ++s) {
+            const uint64_t offset = load32(table + 8 * s);
+            const uint64_t count = load32(table + 8 * s + 4);
+            if (offset > length || count * kRecordSize[s] > length - offset) return false;
+            sectionStart[s] = base + offset;
+            sectionCount[s] = static_cast<uint32_t>(count);
+        }
+        return true;
+    }
+
+    uint32_t header32(std::size_t offset) const { return load32(base + offset); }
+    uint64_t header64(std::size_t offset) const { return load64(base + offset); }
+    uint32_t count(BinarySection s) const { return sectionCount[s]; }
+    const char* record(BinarySection s, uint32_t index) const { return sectionStart[s] + kRecordSize[s] * index; }
+
+    bool range(BinarySection s, uint32_t first, uint32_t n) const {
+        return first <= sectionCount[s] && n <= sectionCount[s] - first;
+    }
+
+    bool string(const char* ref, std::string& out) const {
+        const uint32_t offset = load32(ref);
+        const uint32_t len = load32(ref + 4);
+        if (offset > sectionCount[STRINGS] || len > sectionCount[STRINGS] - offset) return false;
+        out.assign(sectionStart[STRINGS] + offset, len);
+        return true;
+    }
+    bool name(const char* ref, NameId& out) const {
+        const uint32_t offset = load32(ref);
+        const uint32_t len = load32(ref + 4);
+        if (offset > sectionCount[STRINGS] || len > sectionCount[STRINGS] - offset) return false;
+        out = len == 0 ? kNoName : internName(std::string_view(sectionStart[STRINGS] + offset, len));
+        return true;
+    }
+};
+
+static bool readBinaryEmpire(const BinaryReader& r, const char* rec, SavedEmpire& e, uint32_t& flags) {
+    if (!r.string(rec, e.name) || !r.string(rec + 8, e.currentResearch)) return false;
+    e.turn = static_cast<int>(load32(rec + 16));
+    flags = load32(rec + 20);
+    const uint32_t mask = load32(rec + 24);
+    const char* amounts = rec + 28;
+    for (std::size_t i = 0; i < kResourceTypeCount; ++i) {
+        if (mask & (1u << i)) {
+            e.resources.emplace_back(static_cast<ResourceType>(i), static_cast<int>(load32(amounts + 4 * i)));
+        }
+    }
+    const char* spans = amounts + 4 * kResourceTypeCount;
+    const uint32_t techFirst = load32(spans), techCount = load32(spans + 4);
+    const uint32_t colonyFirst = load32(spans + 8), colonyCount = load32(spans + 12);
+    const uint32_t fleetFirst = load32(spans + 16), fleetCount = load32(spans + 20);
+    if (!r.range(TECHS, techFirst, techCount) || !r.range(COLONIES, colonyFirst, colonyCount) ||
+        !r.range(FLEETS, fleetFirst, fleetCount)) {
+        return false;
+    }
+
+    e.techs.resize(techCount);
+    for (uint32_t i = 0; i < techCount; ++i) {
+        const char* t = r.record(TECHS, techFirst + i);
+        SavedTech& tech = e.techs[i];
+        if (!r.string(t, tech.id)) return false;
+        tech.progress = static_cast<int>(load32(t + 8));
+        tech.researched = load32(t + 12) != 0;
+    }
+
+    e.colonies.resize(colonyCount);
+    for (uint32_t i = 0; i < colonyCount; ++i) {
+        const char* c = r.record(COLONIES, colonyFirst + i);
+        SavedColony& colony = e.colonies[i];
+        if (!r.name(c, colony.name) || !r.name(c + 8, colony.system) || !r.name(c + 16, colony.planet)) {
+            return false;
+        }
+        colony.pop = static_cast<int>(load32(c + 24));
+        colony.mines = static_cast<int>(load32(c + 28));
+        colony.factories = static_cast<int>(load32(c + 32));
+    }
+
+    e.fleets.resize(fleetCount);
+    for (uint32_t i = 0; i < fleetCount; ++i) {
+        const char* f = r.record(FLEETS, fleetFirst + i);
+        SavedFleet& fleet = e.fleets[i];
+        if (!r.name(f, fleet.name) || !r.name(f + 8, fleet.system)) return false;
+        const uint32_t shipFirst = load32(f + 16), shipCount = load32(f + 20);
+        if (!r.range(SHIPS, shipFirst, shipCount)) return false;
+        fleet.ships.resize(shipCount);
+        for (uint32_t j = 0; j < shipCount; ++j) {
+            const char* s = r.record(SHIPS, shipFirst + j);
+            SavedShip& ship = fleet.ships[j];
+            if (!r.name(s, ship.name)) return false;
+            const uint32_t cls = load32(s + 8);
+            if (cls > static_cast<uint32_t>(ShipClass::CARRIER)) return false;
+            ship.cls = static_cast<ShipClass>(cls);
+            ship.hull = static_cast<int>(load32(s + 12));
+            ship.shields = static_cast<int>(load32(s + 16));
+        }
+    }
+    return true;
+}
+
+static std::string readBinarySave(const MappedFile& file, SaveData& data) {
+    BinaryReader r(file.data(), file.size());
+    if (!r.open()) return "Cannot load: corrupt save file";
+    if (r.header32(16) != kBinaryVersion) return "Cannot load: unsupported save version";
+
+    data.seed = r.header32(20);
+    data.numSystems = static_cast<int>(r.header32(24));
+    data.haveRngState = (r.header32(28) & kFlagHaveRngState) != 0;
+    data.galaxyGenerator = (r.header32(28) & kFlagCounterStreamGalaxy) != 0 ? GalaxyGenerator::COUNTER_STREAMS
+                                                                            : GalaxyGenerator::SEQUENTIAL_MT19937;
+    data.rngSeed = r.header64(32);
+
+    if (r.count(EMPIRES) == 0) return "Cannot load: corrupt save file";
+    data.hostiles.resize(r.count(EMPIRES) - 1);
+    for (uint32_t i = 0; i < r.count(EMPIRES); ++i) {
+        uint32_t flags = 0;
+        SavedEmpire& e = i == 0 ? data.player : data.hostiles[i - 1].e;
+        if (!readBinaryEmpire(r, r.record(EMPIRES, i), e, flags)) return "Cannot load: corrupt save file";
+        if (i > 0) {
+            data.hostiles[i - 1].contacted = (flags & kEmpireContacted) != 0;
+            data.hostiles[i - 1].atWar = (flags & kEmpireAtWar) != 0;
+        }
+    }
+
+    data.exploredSystems.resize(r.count(EXPLORED));
+    for (uint32_t i = 0; i < r.count(EXPLORED); ++i) {
+        if (!r.name(r.record(EXPLORED, i), data.exploredSystems[i])) return "Cannot load: corrupt save file";
+    }
+
+    for (uint32_t i = 0; i < r.count(RNG); ++i) {
+        const char* rec = r.record(RNG, i);
+        const uint32_t id = load32(rec);
+        if (id >= static_cast<uint32_t>(RngStreamId::COUNT)) continue;
+        data.rngCounters.emplace_back(static_cast<RngStreamId>(id), load64(rec + 8));
+    }
+    return {};
+}
+
+// Forces the file's contents to stable storage.
+static bool syncFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    const bool ok = FlushFileBuffers(h) != 0;
+    CloseHandle(h);
+    return ok;
+#else
+    const int fd = ::open(path.c_str(), O_WRONLY);
+    if (fd < 0) return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(from.c_str(), to.c_str()) != 0) return false;
+    // Persist the directory entry as well; failure here only weakens durability.
+    const std::size_t slash = to.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : to.substr(0, slash));
+    const int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+    return true;
+#endif
+}
+} // namespace
+
+std::string writeSaveFile(const SaveData& data, const std::string& path, SaveFormat format) {
+    return format == SaveFormat::BINARY_V2 ? writeBinarySave(data, path) : writeTextSave(data, path);
+}
+
+std::string writeSaveFileAtomic(const SaveData& data, const std::string& path, SaveFormat format) {
+    const std::string tmpPath = path + ".tmp";
+    std::string error = writeSaveFile(data, tmpPath, format);
+    if (error.empty() && !syncFile(tmpPath)) error = "Cannot save: failed to flush file: " + tmpPath;
+    if (error.empty() && !replaceFile(tmpPath, path)) error = "Cannot save: failed to replace file: " + path;
+    if (!error.empty()) std::remove(tmpPath.c_str());
+    return error;
+}
+
+std::string readSaveFile(const std::string& path, SaveData& out) {
+    out = SaveData{};
+    {
+        const MappedFile file(path);
+        if (file.size() >= sizeof(kBinaryMagic) && std::memcmp(file.data(), kBinaryMagic, sizeof(kBinaryMagic)) == 0) {
+            return readBinarySave(file, out);
+        }
+    }
+    return readTextSave(path, out);
+}
@@ -0,0 +1,312 @@
+// Headless batch simulation driver.
+//
+// Builds a Game, advances it a fixed number of turns with no UI and no turn
+// narrative, then reports throughput and peak memory. Used to soak-test the
+// turn loop at late-game sizes.
+#include "game.h"
+#include "profiler.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+struct SimOptions {
+    long long turns = 1000;
+    uint32_t seed = 1;
+    bool exploreAll = false;
+    std::string logPath;
+    int autosaveEvery = 0;
+    std::string autosavePath = "autosave.sav";
+    int loadBenchMb = 0;
+    std::string tracePath;
+    bool serialAi = false;
+    GameSetup setup;
+};
+
+static void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " --simulate N [--seed S] [--explore-all] [--log FILE]\n"
+              << "       [--systems N] [--ais N] [--placement spread|random]\n"
+              << "       [--autosave N] [--autosave-file FILE] [--trace FILE] [--serial-ai]\n"
+              << "       " << argv0 << " --load-bench MB [--seed S]\n"
+              << "  --simulate N    Advance N turns headlessly (default 1000)\n"
+              << "  --seed S        Galaxy seed (default 1)\n"
+              << "  --explore-all   Explore every system first (makes contact with all hostiles)\n"
+              << "  --systems N     Galaxy size in star systems (default 20)\n"
+              << "  --ais N         Number of AI empires (default 2)\n"
+              << "  --placement P   AI homeworld placement: spread (default) or random\n"
+              << "  --log FILE      Keep the turn narrative and write it to FILE (for replay diffs)\n"
+              << "  --autosave N    Autosave in the background every N turns\n"
+              << "  --autosave-file FILE  Autosave target (default autosave.sav)\n"
+              << "  --trace FILE    Profile each turn phase and write a Chrome trace to FILE\n"
+              << "  --serial-ai     Run AI turns on one thread (output must match the parallel run)\n"
+              << "  --load-bench MB Time loading a synthetic save of about MB megabytes\n";
+}
+
+static bool parseArgs(int argc, char** argv, SimOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto nextValue = [&](const char*& out) -> bool {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+
+        const char* value = nullptr;
+        if (arg == "--simulate" || arg == "-n") {
+            if (!nextValue(value)) return false;
+            opts.turns = std::atoll(value);
+        } else if (arg == "--seed" || arg == "-s") {
+            if (!nextValue(value)) return false;
+            opts.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--systems") {
+            if (!nextValue(value)) return false;
+            opts.setup.galaxySystems = std::atoi(value);
+        } else if (arg == "--ais") {
+            if (!nextValue(value)) return false;
+            opts.setup.aiCount = std::atoi(value);
+        } else if (arg == "--placement") {
+            if (!nextValue(value)) return false;
+            const std::string placement = value;
+            if (placement == "spread") {
+                opts.setup.placement = HomeworldPlacement::SPREAD;
+            } else if (placement == "random") {
+                opts.setup.placement = HomeworldPlacement::RANDOM;
+            } else {
+                return false;
+            }
+        } else if (arg == "--explore-all") {
+            opts.exploreAll = true;
+        } else if (arg == "--log") {
+            if (!nextValue(value)) return false;
+            opts.logPath = value;
+        } else if (arg == "--autosave") {
+            if (!nextValue(value)) return false;
+            opts.autosaveEvery = std::atoi(value);
+        } else if (arg == "--autosave-file") {
+            if (!nextValue(value)) return false;
+            opts.autosavePath = value;
+        } else if (arg == "--trace") {
+            if (!nextValue(value)) return false;
+            opts.tracePath = value;
+        } else if (arg == "--serial-ai") {
+            opts.serialAi = true;
+        } else if (arg == "--load-bench") {
+            if (!nextValue(value)) return false;
+            opts.loadBenchMb = std::atoi(value);
+        } else {
+            return false;
+        }
+    }
+    return opts.turns > 0 && opts.loadBenchMb >= 0 && opts.setup.galaxySystems > 0 && opts.setup.aiCount >= 0;
+}
+
+// Peak resident set size in kilobytes, or 0 if unavailable.
+static long long peakRssKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast<long long>(pmc.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<long long>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<long long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Grows a real game's save with extra player fleets and colonies until its
+// text form is roughly `targetBytes` long.
+static SaveData makeSyntheticSave(const Game& game, const std::vector<std::string>& systems,
+                                  std::size_t targetBytes) {
+    static const ShipClass kClasses[] = {ShipClass::SCOUT, ShipClass::FIGHTER, ShipClass::CORVETTE,
+                                         ShipClass::FRIGATE, ShipClass::DESTROYER, ShipClass::CRUISER,
+                                         ShipClass::BATTLESHIP, ShipClass::CARRIER};
+    SaveData data = game.captureSaveData();
+    std::size_t bytes = 0;
+    for (std::size_t f = 0; bytes < targetBytes; ++f) {
+        const std::string& system = systems[f % systems.size()];
+
+        const std::string colonyName = "Synthetic Colony " + std::to_string(f);
+        const std::string planetName = system + " I";
+        SavedColony colony;
+        colony.name = internName(colonyName);
+        colony.system = internName(system);
+        colony.planet = internName(planetName);
+        colony.pop = static_cast<int>(f % 1000);
+        bytes += colonyName.size() + system.size() + planetName.size() + 60;
+        data.player.colonies.push_back(std::move(colony));
+
+        const std::string fleetName = "Synthetic Fleet " + std::to_string(f);
+        SavedFleet fleet;
+        fleet.name = internName(fleetName);
+        fleet.system = internName(system);
+        bytes += fleetName.size() + system.size() + 24;
+        for (int s = 0; s < 32; ++s) {
+            const std::string shipName = fleetName + " Ship " + std::to_string(s);
+            SavedShip ship;
+            ship.name = internName(shipName);
+            ship.cls = kClasses[s % 8];
+            ship.hull = 100 + s;
+            ship.shields = 50 + s;
+            bytes += shipName.size() + 40;
+            fleet.ships.push_back(std::move(ship));
+        }
+        data.player.fleets.push_back(std::move(fleet));
+    }
+    return data;
+}
+
+// Writes the synthetic save in both formats and reports the best of three
+// parse times for each as MB/s.
+static int runLoadBenchmark(Game& game, int megabytes) {
+    std::vector<std::string> systems;
+    for (const StarSystem& sys : game.getGalaxy()->getSystems()) {
+        systems.push_back(sys.getName());
+    }
+    const SaveData data = makeSyntheticSave(game, systems, static_cast<std::size_t>(megabytes) << 20);
+
+    const struct {
+        SaveFormat format;
+        const char* label;
+        const char* path;
+    } runs[] = {
+        {SaveFormat::TEXT_V1, "V1 text", "load_bench_v1.sav"},
+        {SaveFormat::BINARY_V2, "V2 binary", "load_bench_v2.sav"},
+    };
+
+    for (const auto& run : runs) {
+        const std::string error = writeSaveFile(data, run.path, run.format);
+        if (!error.empty()) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::ifstream sizeProbe(run.path, std::ios::binary | std::ios::ate);
+        const double mb = static_cast<double>(sizeProbe.tellg()) / (1024.0 * 1024.0);
+        sizeProbe.close();
+
+        double best = 0.0;
+        for (int rep = 0; rep < 3; ++rep) {
+            SaveData loaded;
+            const auto start = std::chrono::steady_clock::now();
+            const std::string loadError = readSaveFile(run.path, loaded);
+            const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!loadError.empty()) {
+                std::cerr << loadError << "\n";
+                return 1;
+            }
+            if (rep == 0 || sec < best) best = sec;
+        }
+        std::remove(run.path);
+
+        std::cout << run.label << ": " << mb << " MB in " << best << " s ("
+                  << (best > 0.0 ? mb / best : 0.0) << " MB/s)\n";
+    }
+    return 0;
+}
+
+// Keeps the player researching so the research path is exercised every turn.
+static void autopilotResearch(Game& game) {
+    auto empire = game.getEmpire();
+    if (!empire->getCurrentResearch().empty()) return;
+    auto available = game.getAvailableResearch();
+    if (!available.empty()) {
+        game.startResearch(available[0].getId());
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    SimOptions opts;
+    if (!parseArgs(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Profiler::setEnabled(!opts.tracePath.empty());
+    const auto setupStart = std::chrono::steady_clock::now();
+    Game game("Earth Empire", opts.seed, opts.setup);
+    game.setNarrativeEnabled(!opts.logPath.empty());
+    game.setParallelAiEnabled(!opts.serialAi);
+    game.setAutosave(opts.autosaveEvery, opts.autosavePath);
+
+    std::ofstream logOut;
+    if (!opts.logPath.empty()) {
+        logOut.open(opts.logPath, std::ios::out | std::ios::trunc);
+        if (!logOut.is_open()) {
+            std::cerr << "Cannot open log file: " << opts.logPath << "\n";
+            return 1;
+        }
+    }
+
+    if (opts.exploreAll) {
+        for (const StarSystem& sys : game.getGalaxy()->getSystems()) {
+            game.exploreSystem(sys.getName());
+        }
+    }
+    const auto setupEnd = std::chrono::steady_clock::now();
+
+    if (opts.loadBenchMb > 0) return runLoadBenchmark(game, opts.loadBenchMb);
+
+    for (long long t = 0; t < opts.turns; ++t) {
+        autopilotResearch(game);
+        const std::string narrative = game.advanceTurn();
+        if (logOut.is_open()) logOut << narrative << "\n";
+    }
+    const auto runEnd = std::chrono::steady_clock::now();
+    const std::string autosaveResult = game.flushAutosave();
+
+    const double setupSec = std::chrono::duration<double>(setupEnd - setupStart).count();
+    const double runSec = std::chrono::duration<double>(runEnd - setupEnd).count();
+    const double turnsPerSec = runSec > 0.0 ? static_cast<double>(opts.turns) / runSec : 0.0;
+
+    std::size_t hostileShips = 0;
+    for (const auto& h : game.getHostileEmpires()) {
+        if (!h) continue;
+        for (const auto& f : h->getFleets()) {
+            if (f) hostileShips += f->getShips().size();
+        }
+    }
+
+    std::cout << "Seed: " << opts.seed << "\n"
+              << "Turns: " << opts.turns << "\n"
+              << "Setup time: " << setupSec << " s\n"
+              << "Run time: " << runSec << " s\n"
+              << "Turns/second: " << turnsPerSec << "\n"
+              << "Final turn: " << game.getEmpire()->getTurn() << "\n"
+              << "Researched technologies: " << game.getEmpire()->getResearch().getResearchedCount() << "\n"
+              << "Hostile ships: " << hostileShips << "\n"
+              << "Systems with planets in memory: " << game.getGalaxy()->getDetailedSystemCount() << " of "
+              << game.getGalaxy()->getSystems().size() << "\n"
+              << "Peak RSS: " << peakRssKb() << " KB\n";
+    if (!autosaveResult.empty()) std::cout << "Last autosave: " << autosaveResult << "\n";
+
+    if (!opts.tracePath.empty()) {
+        const std::string traceError = Profiler::writeChromeTrace(opts.tracePath);
+        if (!traceError.empty()) {
+            std::cerr << traceError << "\n";
+            return 1;
+        }
+        std::cout << "Trace written to " << opts.tracePath << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+namespace {
+static int32_t axisValue(int32_t x, int32_t y, int32_t z, int axis) {
+    return axis == 0 ? x : (axis == 1 ? y : z);
+}
+
+static int64_t sq(int64_t v) { return v * v; }
+} // namespace
+
+void SpatialIndex::build(const std::vector<SpatialPoint>& points) {
+    nodes.clear();
+    nodes.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        nodes.push_back(Node{points[i].x, points[i].y, points[i].z, static_cast<uint32_t>(i)});
+    }
+    buildRange(0, nodes.size(), 0);
+}
+
+void SpatialIndex::buildRange(std::size_t lo, std::size_t hi, int depth) {
+    if (hi - lo <= 1) return;
+    const int axis = depth % 3;
+    const std::size_t mid = lo + (hi - lo) / 2;
+    std::nth_element(nodes.begin() + static_cast<std::ptrdiff_t>(lo),
+                     nodes.begin() + static_cast<std::ptrdiff_t>(mid),
+                     nodes.begin() + static_cast<std::ptrdiff_t>(hi),
+                     [axis](const Node& a, const Node& b) {
+                         const int32_t av = axisValue(a.x, a.y, a.z, axis);
+                         const int32_t bv = axisValue(b.x, b.y, b.z, axis);
+                         return av != bv ? av < bv : a.index < b.index;
+                     });
+    buildRange(lo, mid, depth + 1);
+    buildRange(mid + 1, hi, depth + 1);
+}
+
+void SpatialIndex::radiusRange(std::size_t lo, std::size_t hi, int depth, const Node& c, int64_t r2,
+                               std::vector<std::size_t>& out) const {
+    if (lo >= hi) return;
+    const std::size_t mid = lo + (hi - lo) / 2;
+    const Node& n = nodes[mid];
+
+    if (sq(n.x - c.x) + sq(n.y - c.y) + sq(n.z - c.z) <= r2) out.push_back(n.index);
+
+    const int axis = depth % 3;
+    const int64_t delta = static_cast<int64_t>(axisValue(c.x, c.y, c.z, axis)) - axisValue(n.x, n.y, n.z, axis);
+    // Equal keys may sit on either side of the split, so visit both when delta == 0.
+    if (delta <= 0 || sq(delta) <= r2) radiusRange(lo, mid, depth + 1, c, r2, out);
+    if (delta >= 0 || sq(delta) <= r2) radiusRange(mid + 1, hi, depth + 1, c, r2, out);
+}
+
+std::vector<std::size_t> SpatialIndex::withinRadius(int x, int y, int z, double radius) const {
+    std::vector<std::size_t> out;
+    if (radius < 0.0) return out;
+    const int64_t r2 = static_cast<int64_t>(std::floor(radius * radius));
+    radiusRange(0, nodes.size(), 0, Node{x, y, z, 0}, r2, out);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+void SpatialIndex::boxRange(std::size_t lo, std::size_t hi, int depth, const Node& minC, const Node& maxC,
+                            std::vector<std::size_t>& out) const {
+    if (lo >= hi) return;
+    const std::size_t mid = lo + (hi - lo) / 2;
+    const Node& n = nodes[mid];
+
+    if (n.x >= minC.x && n.x <= maxC.x && n.y >= minC.y && n.y <= maxC.y && n.z >= minC.z && n.z <= maxC.z) {
+        out.push_back(n.index);
+    }
+
+    const int axis = depth % 3;
+    const int32_t v = axisValue(n.x, n.y, n.z, axis);
+    if (axisValue(minC.x, minC.y, minC.z, axis) <= v) boxRange(lo, mid, depth + 1, minC, maxC, out);
+    if (axisValue(maxC.x, maxC.y, maxC.z, axis) >= v) boxRange(mid + 1, hi, depth + 1, minC, maxC, out);
+}
+
+std::vector<std::size_t> SpatialIndex::inBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ) const {
+    std::vector<std::size_t> out;
+    boxRange(0, nodes.size(), 0, Node{minX, minY, minZ, 0}, Node{maxX, maxY, maxZ, 0}, out);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+template <typename Heap>
+void SpatialIndex::nearestRange(std::size_t lo, std::size_t hi, int depth, const Node& c, std::size_t k,
+                                Heap& heap) const {
+    if (lo >= hi) return;
+    const std::size_t mid = lo + (hi - lo) / 2;
+    const Node& n = nodes[mid];
+
+    const std::pair<int64_t, uint32_t> cand(sq(n.x - c.x) + sq(n.y - c.y) + sq(n.z - c.z), n.index);
+    if (heap.size() < k) {
+        heap.push(cand);
+    } else if (cand < heap.top()) {
+        heap.pop();
+        heap.push(cand);
+    }
+
+    const int axis = depth % 3;
+    const int64_t delta = static_cast<int64_t>(axisValue(c.x, c.y, c.z, axis)) - axisValue(n.x, n.y, n.z, axis);
+    const bool leftFirst = delta <= 0;
+    const std::size_t nearLo = leftFirst ? lo : mid + 1;
+    const std::size_t nearHi = leftFirst ? mid : hi;
+    const std::size_t farLo = leftFirst ? mid + 1 : lo;
+    const std::size_t farHi = leftFirst ? hi : mid;
+
+    nearestRange(nearLo, nearHi, depth + 1, c, k, heap);
+    // <= keeps equal-distance candidates with smaller indices reachable.
+    if (heap.size() < k || sq(delta) <= heap.top().first) {
+        nearestRange(farLo, farHi, depth + 1, c, k, heap);
+    }
+}
+
+std::vector<std::size_t> SpatialIndex::nearest(int x, int y, int z, std::size_t k) const {
+    std::vector<std::size_t> out;
+    if (k == 0 || nodes.empty()) return out;
+
+    // Max-heap on (distance, index) holding the best k seen so far.
+    std::priority_queue<std::pair<int64_t, uint32_t>> heap;
+    nearestRange(0, nodes.size(), 0, Node{x, y, z, 0}, k, heap);
+
+    out.resize(heap.size());
+    for (std::size_t i = out.size(); i-- > 0;) {
+        out[i] = heap.top().second;
+        heap.pop();
+    }
+    return out;
+}
@@ -0,0 +1,96 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(std::size_t threads) : stopping(false) {
+    if (threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    // The caller of parallelFor() is the remaining thread.
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& fn,
+                             std::size_t minChunk) {
+    if (count == 0) return;
+
+    const std::size_t threads = size();
+    if (threads == 1 || count <= minChunk) {
+        fn(0, count);
+        return;
+    }
+
+    // A few chunks per thread keeps the load balanced without much overhead.
+    const std::size_t chunk = std::max(minChunk, (count + threads * 4 - 1) / (threads * 4));
+    const std::size_t numChunks = (count + chunk - 1) / chunk;
+
+    // Shared state outlives this call: helpers that start late find no chunks left.
+    struct Job {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+    };
+    auto job = std::make_shared<Job>();
+
+    auto runChunks = [job, &fn, count, chunk, numChunks]() {
+        for (;;) {
+            const std::size_t c = job->next.fetch_add(1);
+            if (c >= numChunks) return;
+            const std::size_t begin = c * chunk;
+            fn(begin, std::min(count, begin + chunk));
+            if (job->done.fetch_add(1) + 1 == numChunks) {
+                std::lock_guard<std::mutex> lock(job->doneMutex);
+                job->doneCv.notify_all();
+            }
+        }
+    };
+
+    const std::size_t helpers = std::min(workers.size(), numChunks - 1);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        // Helpers copy the job pointer but only touch fn while chunks remain,
+        // which is always before this call returns.
+        post(runChunks);
+    }
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(job->doneMutex);
+    job->doneCv.wait(lock, [&job, numChunks]() { return job->done.load() == numChunks; });
+}